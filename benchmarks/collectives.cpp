@@ -0,0 +1,89 @@
+// OSU-style collective sweeps over message size, each run through the
+// mpicxx API and through the equivalent raw nonblocking MPI call plus
+// MPI_Wait. Values are the slowest rank's average usec per call; bytes is
+// the per-rank buffer (per destination for alltoall).
+//
+//   mpirun -np 8 bench_collectives [--iterations N] [--warmup N] [--max-bytes N] [--json]
+
+#include <vector>
+
+#include "common.hpp"
+
+int main(int argc, char **argv)
+{
+    mpicxx::environment env(argc, argv);
+    auto world = mpicxx::comm::world();
+    bench::options opts = bench::parse_options(argc, argv);
+    int ranks = world.size();
+    MPI_Comm raw = world.get();
+    bench::reporter out(opts, world);
+
+    for (std::size_t bytes : bench::message_sizes(sizeof(double), opts.max_bytes))
+    {
+        int count = int(bytes / sizeof(double));
+        int warmup = bench::warmup_for(opts, bytes);
+        int iterations = bench::iterations_for(opts, bytes);
+        std::vector<double> send(count, 1.0);
+        std::vector<double> recv(count);
+        double seconds = bench::time_per_call(
+            world, warmup, iterations,
+            [&]()
+            { world.iallreduce(send.data(), recv.data(), count, mpicxx::op::sum()).wait(); });
+        out.record("allreduce", "mpicxx", ranks, bytes, seconds * 1e6, "usec");
+        seconds = bench::time_per_call(
+            world, warmup, iterations,
+            [&]()
+            {
+                MPI_Request request;
+                MPI_Iallreduce(send.data(), recv.data(), count, MPI_DOUBLE, MPI_SUM, raw, &request);
+                MPI_Wait(&request, MPI_STATUS_IGNORE);
+            });
+        out.record("allreduce", "raw", ranks, bytes, seconds * 1e6, "usec");
+    }
+
+    for (std::size_t bytes : bench::message_sizes(1, opts.max_bytes))
+    {
+        int count = int(bytes);
+        int warmup = bench::warmup_for(opts, bytes);
+        int iterations = bench::iterations_for(opts, bytes);
+        std::vector<char> buf(bytes, 'a');
+        double seconds = bench::time_per_call(
+            world, warmup, iterations,
+            [&]()
+            { world.ibcast(buf.data(), bytes, 0).wait(); });
+        out.record("bcast", "mpicxx", ranks, bytes, seconds * 1e6, "usec");
+        seconds = bench::time_per_call(
+            world, warmup, iterations,
+            [&]()
+            {
+                MPI_Request request;
+                MPI_Ibcast(buf.data(), count, MPI_CHAR, 0, raw, &request);
+                MPI_Wait(&request, MPI_STATUS_IGNORE);
+            });
+        out.record("bcast", "raw", ranks, bytes, seconds * 1e6, "usec");
+    }
+
+    std::size_t alltoall_max = std::max<std::size_t>(opts.max_bytes / std::size_t(ranks), 1);
+    for (std::size_t bytes : bench::message_sizes(1, alltoall_max))
+    {
+        int count = int(bytes);
+        int warmup = bench::warmup_for(opts, bytes);
+        int iterations = bench::iterations_for(opts, bytes);
+        std::vector<char> send(bytes * ranks, 'a');
+        std::vector<char> recv(bytes * ranks);
+        double seconds = bench::time_per_call(
+            world, warmup, iterations,
+            [&]()
+            { world.ialltoall(send.data(), recv.data(), count).wait(); });
+        out.record("alltoall", "mpicxx", ranks, bytes, seconds * 1e6, "usec");
+        seconds = bench::time_per_call(
+            world, warmup, iterations,
+            [&]()
+            {
+                MPI_Request request;
+                MPI_Ialltoall(send.data(), count, MPI_CHAR, recv.data(), count, MPI_CHAR, raw, &request);
+                MPI_Wait(&request, MPI_STATUS_IGNORE);
+            });
+        out.record("alltoall", "raw", ranks, bytes, seconds * 1e6, "usec");
+    }
+}
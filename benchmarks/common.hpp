@@ -0,0 +1,153 @@
+#ifndef MPICPP_BENCHMARKS_COMMON_HPP
+#define MPICPP_BENCHMARKS_COMMON_HPP
+#pragma once
+
+// Shared option parsing, timing and output for the OSU-style benchmarks.
+// Every benchmark accepts
+//   --iterations N  timed iterations for messages up to 8 KiB (default 1000)
+//   --warmup N      untimed iterations before each measurement (default 100)
+//   --max-bytes N   largest message size in the sweep (default 4 MiB)
+//   --json          JSON array of records instead of CSV
+// and prints one record per (benchmark, variant, size) from rank 0. Compare
+// variants in an optimized build (CMAKE_BUILD_TYPE=Release); the wrappers
+// rely on inlining.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "mpicpp.hpp"
+
+namespace bench
+{
+    struct options
+    {
+        int iterations = 1000;
+        int warmup = 100;
+        std::size_t max_bytes = std::size_t(1) << 22;
+        bool json = false;
+    };
+
+    inline options parse_options(int argc, char **argv)
+    {
+        options result;
+        for (int i = 1; i < argc; ++i)
+        {
+            if (std::strcmp(argv[i], "--json") == 0)
+            {
+                result.json = true;
+            }
+            else if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+            {
+                result.iterations = std::atoi(argv[++i]);
+            }
+            else if (std::strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+            {
+                result.warmup = std::atoi(argv[++i]);
+            }
+            else if (std::strcmp(argv[i], "--max-bytes") == 0 && i + 1 < argc)
+            {
+                result.max_bytes = std::strtoull(argv[++i], nullptr, 10);
+            }
+        }
+        return result;
+    }
+
+    // Large messages are timed over fewer iterations, as in the OSU suite.
+    inline int iterations_for(options const &opts, std::size_t bytes)
+    {
+        return bytes > 8192 ? std::max(opts.iterations / 10, 10) : opts.iterations;
+    }
+
+    inline int warmup_for(options const &opts, std::size_t bytes)
+    {
+        return bytes > 8192 ? std::max(opts.warmup / 10, 2) : opts.warmup;
+    }
+
+    inline std::vector<std::size_t> message_sizes(std::size_t first, std::size_t last)
+    {
+        std::vector<std::size_t> sizes;
+        for (std::size_t bytes = first; bytes <= last; bytes *= 2)
+        {
+            sizes.push_back(bytes);
+        }
+        return sizes;
+    }
+
+    // Slowest rank's average seconds per call to f after warmup.
+    template <class F>
+    double time_per_call(mpicxx::comm const &world, int warmup, int iterations, F &&f)
+    {
+        for (int i = 0; i < warmup; ++i)
+        {
+            f();
+        }
+        world.ibarrier().wait();
+        double start = MPI_Wtime();
+        for (int i = 0; i < iterations; ++i)
+        {
+            f();
+        }
+        double local = (MPI_Wtime() - start) / iterations;
+        double slowest = local;
+        mpicxx::handle_error(MPI_Allreduce(&local, &slowest, 1, MPI_DOUBLE, MPI_MAX, world.get()));
+        return slowest;
+    }
+
+    class reporter
+    {
+        bool json;
+        bool active;
+        bool first = true;
+
+    public:
+        reporter(options const &opts, mpicxx::comm const &world)
+            : json(opts.json), active(world.rank() == 0)
+        {
+            if (!active)
+            {
+                return;
+            }
+            if (json)
+            {
+                std::printf("[\n");
+            }
+            else
+            {
+                std::printf("benchmark,variant,ranks,bytes,value,unit\n");
+            }
+        }
+        reporter(reporter const &) = delete;
+        reporter &operator=(reporter const &) = delete;
+        ~reporter()
+        {
+            if (active && json)
+            {
+                std::printf("\n]\n");
+            }
+        }
+        void record(char const *benchmark, char const *variant, int ranks, std::size_t bytes, double value, char const *unit)
+        {
+            if (!active)
+            {
+                return;
+            }
+            if (json)
+            {
+                std::printf("%s  {\"benchmark\": \"%s\", \"variant\": \"%s\", \"ranks\": %d, \"bytes\": %zu, \"value\": %.6f, \"unit\": \"%s\"}",
+                            first ? "" : ",\n", benchmark, variant, ranks, bytes, value, unit);
+            }
+            else
+            {
+                std::printf("%s,%s,%d,%zu,%.6f,%s\n", benchmark, variant, ranks, bytes, value, unit);
+            }
+            first = false;
+            std::fflush(stdout);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,127 @@
+// Compares flat and node-aware (hierarchical_comm) collectives.
+//
+//   mpirun -np 16 bench_hierarchical [ranks_per_pseudo_node] [iterations]
+//
+// With ranks_per_pseudo_node > 0 every shared-memory node is split into
+// pseudo-nodes of that size, so the leader exchange is exercised on a single
+// machine. Output is CSV: operation,variant,count,bytes,usec_per_call
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "mpicpp.hpp"
+
+namespace
+{
+    template <class F>
+    double time_per_call(mpicxx::comm const &world, int iterations, F &&f)
+    {
+        f();
+        world.ibarrier().wait();
+        double start = MPI_Wtime();
+        for (int i = 0; i < iterations; ++i)
+        {
+            f();
+        }
+        double local = (MPI_Wtime() - start) / iterations;
+        double slowest = local;
+        mpicxx::handle_error(MPI_Allreduce(&local, &slowest, 1, MPI_DOUBLE, MPI_MAX, world.get()));
+        return slowest * 1e6;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    mpicxx::environment env(argc, argv);
+    auto world = mpicxx::comm::world();
+    int ranks_per_node = argc > 1 ? std::atoi(argv[1]) : 0;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+    mpicxx::hierarchical_comm hier = ranks_per_node > 0
+                                         ? mpicxx::hierarchical_comm(world, ranks_per_node)
+                                         : mpicxx::hierarchical_comm(world);
+    int rank = world.rank();
+    int size = world.size();
+    if (rank == 0)
+    {
+        std::printf("# ranks=%d nodes=%d\n", size, hier.node_count());
+        std::printf("operation,variant,count,bytes,usec_per_call\n");
+    }
+
+    for (int count = 1; count <= (1 << 20); count *= 4)
+    {
+        std::vector<double> flat(count, rank + 1.0);
+        std::vector<double> nodeaware(count, rank + 1.0);
+        auto &flat_buf = flat;
+        auto &hier_buf = nodeaware;
+        double flat_us = time_per_call(
+            world, iterations,
+            [&]()
+            {
+                std::fill(flat_buf.begin(), flat_buf.end(), rank + 1.0);
+                world.iallreduce(flat_buf.data(), count, mpicxx::op::sum()).wait();
+            });
+        double hier_us = time_per_call(
+            world, iterations,
+            [&]()
+            {
+                std::fill(hier_buf.begin(), hier_buf.end(), rank + 1.0);
+                hier.allreduce(hier_buf.data(), count, mpicxx::op::sum());
+            });
+        if (flat != nodeaware)
+        {
+            std::fprintf(stderr, "allreduce mismatch at count %d on rank %d\n", count, rank);
+            return 1;
+        }
+        double bcast_flat_us = time_per_call(
+            world, iterations,
+            [&]()
+            { world.ibcast(flat_buf, 0).wait(); });
+        double bcast_hier_us = time_per_call(
+            world, iterations,
+            [&]()
+            { hier.bcast(hier_buf.data(), count, 0); });
+        if (rank == 0)
+        {
+            std::size_t bytes = std::size_t(count) * sizeof(double);
+            std::printf("allreduce,flat,%d,%zu,%.3f\n", count, bytes, flat_us);
+            std::printf("allreduce,hierarchical,%d,%zu,%.3f\n", count, bytes, hier_us);
+            std::printf("bcast,flat,%d,%zu,%.3f\n", count, bytes, bcast_flat_us);
+            std::printf("bcast,hierarchical,%d,%zu,%.3f\n", count, bytes, bcast_hier_us);
+        }
+    }
+
+    for (int count = 1; count <= (1 << 14); count *= 8)
+    {
+        std::vector<double> send(count, rank);
+        std::vector<double> flat(std::size_t(count) * size);
+        std::vector<double> nodeaware(std::size_t(count) * size);
+        double flat_us = time_per_call(
+            world, iterations,
+            [&]()
+            {
+                mpicxx::handle_error(MPI_Allgather(send.data(), count, MPI_DOUBLE, flat.data(), count, MPI_DOUBLE, world.get()));
+            });
+        double hier_us = time_per_call(
+            world, iterations,
+            [&]()
+            { hier.allgather(send.data(), count, nodeaware.data()); });
+        if (flat != nodeaware)
+        {
+            std::fprintf(stderr, "allgather mismatch at count %d on rank %d\n", count, rank);
+            return 1;
+        }
+        double gather_us = time_per_call(
+            world, iterations,
+            [&]()
+            { hier.gather(send.data(), count, nodeaware.data(), size - 1); });
+        if (rank == 0)
+        {
+            std::size_t bytes = std::size_t(count) * sizeof(double);
+            std::printf("allgather,flat,%d,%zu,%.3f\n", count, bytes, flat_us);
+            std::printf("allgather,hierarchical,%d,%zu,%.3f\n", count, bytes, hier_us);
+            std::printf("gather,hierarchical,%d,%zu,%.3f\n", count, bytes, gather_us);
+        }
+    }
+}
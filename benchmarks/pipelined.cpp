@@ -0,0 +1,96 @@
+// End-to-end time of a gradient-style allreduce followed by an optimizer
+// update (Adam-like, a few flops per element), run monolithically
+// (iallreduce, wait, update everything) and pipelined (iallreduce_pipelined
+// updating each segment while the next ones are still reducing). Values are
+// the slowest rank's average usec per reduce+update; bytes is the buffer.
+//
+//   mpirun -np 8 bench_pipelined [--segment-bytes N] [--depth N]
+//                                [--iterations N] [--warmup N] [--max-bytes N] [--json]
+//
+// --segment-bytes defaults to 256 KiB and --depth (segments in flight) to 2.
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "common.hpp"
+
+namespace
+{
+    struct optimizer
+    {
+        std::vector<double> params;
+        std::vector<double> first;
+        std::vector<double> second;
+
+        explicit optimizer(std::size_t count)
+            : params(count, 1.0), first(count), second(count)
+        {
+        }
+
+        void update(double const *gradient, std::size_t offset, std::size_t count)
+        {
+            for (std::size_t i = offset; i < offset + count; ++i)
+            {
+                double g = gradient[i];
+                first[i] = 0.9 * first[i] + 0.1 * g;
+                second[i] = 0.999 * second[i] + 0.001 * g * g;
+                params[i] -= 1e-3 * first[i] / (std::sqrt(second[i]) + 1e-8);
+            }
+        }
+    };
+}
+
+int main(int argc, char **argv)
+{
+    mpicxx::environment env(argc, argv);
+    auto world = mpicxx::comm::world();
+    bench::options opts = bench::parse_options(argc, argv);
+    std::size_t segment_bytes = std::size_t(1) << 18;
+    int depth = 2;
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--segment-bytes") == 0)
+        {
+            segment_bytes = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--depth") == 0)
+        {
+            depth = std::atoi(argv[++i]);
+        }
+    }
+    std::size_t segment = std::max<std::size_t>(segment_bytes / sizeof(double), 1);
+    int ranks = world.size();
+    bench::reporter out(opts, world);
+
+    for (std::size_t bytes : bench::message_sizes(std::size_t(1) << 16, opts.max_bytes))
+    {
+        std::size_t count = bytes / sizeof(double);
+        int warmup = bench::warmup_for(opts, bytes);
+        int iterations = bench::iterations_for(opts, bytes);
+        std::vector<double> local(count, 1e-3);
+        std::vector<double> gradient(count);
+        optimizer state(count);
+        double seconds = bench::time_per_call(
+            world, warmup, iterations,
+            [&]()
+            {
+                world.iallreduce(local.data(), gradient.data(), count, mpicxx::op::sum()).wait();
+                state.update(gradient.data(), 0, count);
+            });
+        out.record("allreduce_update", "monolithic", ranks, bytes, seconds * 1e6, "usec");
+        seconds = bench::time_per_call(
+            world, warmup, iterations,
+            [&]()
+            {
+                world.iallreduce_pipelined(
+                         local.data(), gradient.data(), count, mpicxx::op::sum(), segment,
+                         [&](std::size_t offset, std::size_t length)
+                         { state.update(gradient.data(), offset, length); },
+                         depth)
+                    .wait();
+            });
+        out.record("allreduce_update", "pipelined", ranks, bytes, seconds * 1e6, "usec");
+    }
+}
@@ -0,0 +1,204 @@
+// OSU-style point-to-point benchmarks between ranks 0 and 1, each run
+// through the mpicxx API and through the equivalent raw MPI calls
+// (MPI_Isend/MPI_Irecv with MPI_Wait/MPI_Waitall):
+//
+//   latency  ping-pong, half round-trip time in usec
+//   bw       window of sends from 0 to 1, MB/s
+//   bibw     windows in both directions at once, MB/s
+//   msgrate  window of sends from 0 to 1, messages per second
+//
+//   mpirun -np 2 bench_pt2pt [--iterations N] [--warmup N] [--max-bytes N] [--json]
+
+#include <vector>
+
+#include "common.hpp"
+
+namespace
+{
+    int const window = 64;
+    int const tag = 1;
+
+    double latency_mpicxx(mpicxx::comm const &world, bench::options const &opts, std::vector<char> &buf, int count)
+    {
+        int rank = world.rank();
+        std::size_t bytes = std::size_t(count);
+        return bench::time_per_call(
+            world, bench::warmup_for(opts, bytes), bench::iterations_for(opts, bytes),
+            [&]()
+            {
+                if (rank == 0)
+                {
+                    world.isend(buf.data(), count, 1, tag).wait();
+                    world.irecv(buf.data(), count, 1, tag).wait();
+                }
+                else if (rank == 1)
+                {
+                    world.irecv(buf.data(), count, 0, tag).wait();
+                    world.isend(buf.data(), count, 0, tag).wait();
+                }
+            });
+    }
+
+    double latency_raw(mpicxx::comm const &world, bench::options const &opts, std::vector<char> &buf, int count)
+    {
+        int rank = world.rank();
+        MPI_Comm raw = world.get();
+        std::size_t bytes = std::size_t(count);
+        return bench::time_per_call(
+            world, bench::warmup_for(opts, bytes), bench::iterations_for(opts, bytes),
+            [&]()
+            {
+                MPI_Request request;
+                if (rank == 0)
+                {
+                    MPI_Isend(buf.data(), count, MPI_CHAR, 1, tag, raw, &request);
+                    MPI_Wait(&request, MPI_STATUS_IGNORE);
+                    MPI_Irecv(buf.data(), count, MPI_CHAR, 1, tag, raw, &request);
+                    MPI_Wait(&request, MPI_STATUS_IGNORE);
+                }
+                else if (rank == 1)
+                {
+                    MPI_Irecv(buf.data(), count, MPI_CHAR, 0, tag, raw, &request);
+                    MPI_Wait(&request, MPI_STATUS_IGNORE);
+                    MPI_Isend(buf.data(), count, MPI_CHAR, 0, tag, raw, &request);
+                    MPI_Wait(&request, MPI_STATUS_IGNORE);
+                }
+            });
+    }
+
+    // One window of sends (from 0, and from 1 too when both_ways), closed
+    // by a zero-byte acknowledgement from the receiver.
+    double window_mpicxx(mpicxx::comm const &world, bench::options const &opts, std::vector<char> &sendbuf, std::vector<char> &recvbuf, int count, bool both_ways)
+    {
+        int rank = world.rank();
+        std::size_t bytes = std::size_t(count);
+        std::vector<mpicxx::request> requests(2 * window);
+        return bench::time_per_call(
+            world, bench::warmup_for(opts, bytes), bench::iterations_for(opts, bytes),
+            [&]()
+            {
+                if (rank > 1)
+                {
+                    return;
+                }
+                int peer = 1 - rank;
+                int posted = 0;
+                if (rank == 1 || both_ways)
+                {
+                    for (int i = 0; i < window; ++i)
+                    {
+                        requests[posted++] = world.irecv(recvbuf.data(), count, peer, tag);
+                    }
+                }
+                if (rank == 0 || both_ways)
+                {
+                    for (int i = 0; i < window; ++i)
+                    {
+                        requests[posted++] = world.isend(sendbuf.data(), count, peer, tag);
+                    }
+                }
+                mpicxx::waitall(posted, requests.data());
+                if (rank == 0)
+                {
+                    world.irecv(recvbuf.data(), 0, peer, tag + 1).wait();
+                }
+                else
+                {
+                    world.isend(sendbuf.data(), 0, peer, tag + 1).wait();
+                }
+            });
+    }
+
+    double window_raw(mpicxx::comm const &world, bench::options const &opts, std::vector<char> &sendbuf, std::vector<char> &recvbuf, int count, bool both_ways)
+    {
+        int rank = world.rank();
+        MPI_Comm raw = world.get();
+        std::size_t bytes = std::size_t(count);
+        std::vector<MPI_Request> requests(2 * window);
+        return bench::time_per_call(
+            world, bench::warmup_for(opts, bytes), bench::iterations_for(opts, bytes),
+            [&]()
+            {
+                if (rank > 1)
+                {
+                    return;
+                }
+                int peer = 1 - rank;
+                int posted = 0;
+                if (rank == 1 || both_ways)
+                {
+                    for (int i = 0; i < window; ++i)
+                    {
+                        MPI_Irecv(recvbuf.data(), count, MPI_CHAR, peer, tag, raw, &requests[posted++]);
+                    }
+                }
+                if (rank == 0 || both_ways)
+                {
+                    for (int i = 0; i < window; ++i)
+                    {
+                        MPI_Isend(sendbuf.data(), count, MPI_CHAR, peer, tag, raw, &requests[posted++]);
+                    }
+                }
+                MPI_Waitall(posted, requests.data(), MPI_STATUSES_IGNORE);
+                MPI_Request ack;
+                if (rank == 0)
+                {
+                    MPI_Irecv(recvbuf.data(), 0, MPI_CHAR, peer, tag + 1, raw, &ack);
+                }
+                else
+                {
+                    MPI_Isend(sendbuf.data(), 0, MPI_CHAR, peer, tag + 1, raw, &ack);
+                }
+                MPI_Wait(&ack, MPI_STATUS_IGNORE);
+            });
+    }
+}
+
+int main(int argc, char **argv)
+{
+    mpicxx::environment env(argc, argv);
+    auto world = mpicxx::comm::world();
+    bench::options opts = bench::parse_options(argc, argv);
+    if (world.size() < 2)
+    {
+        if (world.rank() == 0)
+        {
+            std::fprintf(stderr, "bench_pt2pt needs at least 2 ranks\n");
+        }
+        return 1;
+    }
+    int ranks = world.size();
+    std::vector<char> sendbuf(opts.max_bytes, 'a');
+    std::vector<char> recvbuf(opts.max_bytes, 'b');
+    bench::reporter out(opts, world);
+
+    for (std::size_t bytes : bench::message_sizes(1, opts.max_bytes))
+    {
+        int count = int(bytes);
+        double seconds = latency_mpicxx(world, opts, sendbuf, count);
+        out.record("latency", "mpicxx", ranks, bytes, seconds * 1e6 / 2, "usec");
+        seconds = latency_raw(world, opts, sendbuf, count);
+        out.record("latency", "raw", ranks, bytes, seconds * 1e6 / 2, "usec");
+    }
+    for (std::size_t bytes : bench::message_sizes(1, opts.max_bytes))
+    {
+        int count = int(bytes);
+        double volume = double(bytes) * window / 1e6;
+        double seconds = window_mpicxx(world, opts, sendbuf, recvbuf, count, false);
+        out.record("bw", "mpicxx", ranks, bytes, volume / seconds, "MB/s");
+        seconds = window_raw(world, opts, sendbuf, recvbuf, count, false);
+        out.record("bw", "raw", ranks, bytes, volume / seconds, "MB/s");
+        seconds = window_mpicxx(world, opts, sendbuf, recvbuf, count, true);
+        out.record("bibw", "mpicxx", ranks, bytes, 2 * volume / seconds, "MB/s");
+        seconds = window_raw(world, opts, sendbuf, recvbuf, count, true);
+        out.record("bibw", "raw", ranks, bytes, 2 * volume / seconds, "MB/s");
+    }
+    for (std::size_t bytes : bench::message_sizes(1, std::min<std::size_t>(opts.max_bytes, 8192)))
+    {
+        int count = int(bytes);
+        double seconds = window_mpicxx(world, opts, sendbuf, recvbuf, count, false);
+        out.record("msgrate", "mpicxx", ranks, bytes, window / seconds, "msg/s");
+        seconds = window_raw(world, opts, sendbuf, recvbuf, count, false);
+        out.record("msgrate", "raw", ranks, bytes, window / seconds, "msg/s");
+    }
+}
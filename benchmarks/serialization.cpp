@@ -0,0 +1,154 @@
+// Compares the packed serialization path with a serialize-to-string
+// baseline (length-prefixed fields appended to a std::string, then parsed
+// back element by element), locally and through a broadcast.
+//
+//   mpirun -np 4 bench_serialization [iterations]
+//
+// Output is CSV: operation,variant,elements,bytes,usec_per_call
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "mpicpp.hpp"
+
+namespace
+{
+    template <class F>
+    double time_per_call(mpicxx::comm const &world, int iterations, F &&f)
+    {
+        f();
+        world.ibarrier().wait();
+        double start = MPI_Wtime();
+        for (int i = 0; i < iterations; ++i)
+        {
+            f();
+        }
+        double local = (MPI_Wtime() - start) / iterations;
+        double slowest = local;
+        mpicxx::handle_error(MPI_Allreduce(&local, &slowest, 1, MPI_DOUBLE, MPI_MAX, world.get()));
+        return slowest * 1e6;
+    }
+
+    std::string to_string_archive(std::vector<std::string> const &value)
+    {
+        std::string archive = std::to_string(value.size()) + ' ';
+        for (auto const &item : value)
+        {
+            archive += std::to_string(item.size());
+            archive += ' ';
+            archive += item;
+        }
+        return archive;
+    }
+
+    void from_string_archive(std::string const &archive, std::vector<std::string> &value)
+    {
+        char const *in = archive.c_str();
+        char *next;
+        std::size_t count = std::strtoull(in, &next, 10);
+        in = next + 1;
+        value.clear();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::size_t length = std::strtoull(in, &next, 10);
+            in = next + 1;
+            value.emplace_back(in, length);
+            in += length;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    mpicxx::environment env(argc, argv);
+    auto world = mpicxx::comm::world();
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 50;
+    int rank = world.rank();
+    if (rank == 0)
+    {
+        std::printf("operation,variant,elements,bytes,usec_per_call\n");
+    }
+
+    for (int count = 16; count <= (1 << 16); count *= 16)
+    {
+        std::vector<std::string> source;
+        for (int i = 0; i < count; ++i)
+        {
+            source.push_back("key_" + std::to_string(i) + std::string(std::size_t(i % 64), 'x'));
+        }
+        std::size_t bytes = mpicxx::pack(source).size();
+
+        std::vector<std::string> result;
+        double string_local_us = time_per_call(
+            world, iterations,
+            [&]()
+            { from_string_archive(to_string_archive(source), result); });
+        double packed_local_us = time_per_call(
+            world, iterations,
+            [&]()
+            { mpicxx::unpack(mpicxx::pack(source), result); });
+        std::vector<char> packed = mpicxx::pack(source);
+        std::size_t viewed = 0;
+        double view_local_us = time_per_call(
+            world, iterations,
+            [&]()
+            {
+                mpicxx::ragged_view<char> view(packed);
+                for (std::size_t i = 0; i < view.size(); ++i)
+                {
+                    viewed += view[i].size();
+                }
+            });
+
+        double string_bcast_us = time_per_call(
+            world, iterations,
+            [&]()
+            {
+                std::string archive;
+                if (rank == 0)
+                {
+                    archive = to_string_archive(source);
+                }
+                world.ibcast(archive, 0).wait();
+                from_string_archive(archive, result);
+            });
+        double packed_bcast_us = time_per_call(
+            world, iterations,
+            [&]()
+            {
+                if (rank == 0)
+                {
+                    result = source;
+                }
+                world.ibcast_serialized(result, 0).wait();
+            });
+        if (result != source)
+        {
+            std::fprintf(stderr, "bcast mismatch at count %d on rank %d\n", count, rank);
+            return 1;
+        }
+        // Checking the view total keeps its loop from being optimized away;
+        // time_per_call runs the body once more as a warmup.
+        std::size_t characters = 0;
+        for (std::string const &element : source)
+        {
+            characters += element.size();
+        }
+        if (viewed != characters * std::size_t(iterations + 1))
+        {
+            std::fprintf(stderr, "view mismatch at count %d on rank %d\n", count, rank);
+            return 1;
+        }
+        if (rank == 0)
+        {
+            std::printf("roundtrip,string,%d,%zu,%.3f\n", count, bytes, string_local_us);
+            std::printf("roundtrip,packed,%d,%zu,%.3f\n", count, bytes, packed_local_us);
+            std::printf("roundtrip,view,%d,%zu,%.3f\n", count, bytes, view_local_us);
+            std::printf("bcast,string,%d,%zu,%.3f\n", count, bytes, string_bcast_us);
+            std::printf("bcast,packed,%d,%zu,%.3f\n", count, bytes, packed_bcast_us);
+        }
+    }
+}
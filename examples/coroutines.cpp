@@ -0,0 +1,86 @@
+// Coroutine tasks driven by mpicxx::scheduler. Each rank runs a ring
+// exchange and a reduction as separate tasks, plus one that fails while
+// the others are still waiting on their requests; run() rethrows that
+// failure only once the other tasks have finished. Needs C++20.
+//
+//   mpirun -np 4 example_coroutines
+
+#include <cstdio>
+#include <stdexcept>
+
+#include "mpicpp.hpp"
+
+#ifdef MPICXX_HAS_COROUTINES
+
+namespace
+{
+    mpicxx::task ring(mpicxx::comm const &world, int &received)
+    {
+        int size = world.size();
+        int rank = world.rank();
+        int sent = rank;
+        mpicxx::request sending = world.isend(&sent, 1, (rank + 1) % size, 0);
+        co_await world.irecv(&received, 1, (rank + size - 1) % size, 0);
+        co_await std::move(sending);
+    }
+
+    mpicxx::task total(mpicxx::comm const &world, int &sum)
+    {
+        int one = 1;
+        co_await world.iallreduce(&one, &sum, 1, mpicxx::op::sum());
+    }
+
+    mpicxx::task fail()
+    {
+        throw std::runtime_error("task failed");
+        co_return;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    mpicxx::environment env(argc, argv);
+    auto world = mpicxx::comm::world();
+    int rank = world.rank();
+    int size = world.size();
+    int failures = 0;
+
+    int received = -1;
+    int sum = 0;
+    mpicxx::scheduler scheduler;
+    scheduler.spawn(fail());
+    scheduler.spawn(ring(world, received));
+    scheduler.spawn(total(world, sum));
+    bool rethrown = false;
+    try
+    {
+        scheduler.run();
+    }
+    catch (std::runtime_error const &)
+    {
+        rethrown = true;
+    }
+    failures += !rethrown;
+    failures += received != (rank + size - 1) % size;
+    failures += sum != size;
+
+    if (failures != 0)
+    {
+        std::fprintf(stderr, "rank %d: %d coroutine results wrong\n", rank, failures);
+        return 1;
+    }
+    if (rank == 0)
+    {
+        std::printf("coroutine tasks ok\n");
+    }
+}
+
+#else
+
+int main()
+{
+    std::fprintf(stderr, "example_coroutines needs a compiler with C++20 coroutines\n");
+    return 1;
+}
+
+#endif
@@ -0,0 +1,94 @@
+// Several multi-phase collectives outstanding at once on one communicator.
+// Variable-length broadcasts and serialized gathers share a private
+// duplicate of the communicator for their second phases, so each rank
+// completes them in the same order; pipelined reductions run on their own
+// duplicates and may complete in any order.
+//
+//   mpirun -np 4 example_multiphase
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "mpicpp.hpp"
+
+int main(int argc, char **argv)
+{
+    mpicxx::environment env(argc, argv);
+    auto world = mpicxx::comm::world();
+    int rank = world.rank();
+    int last = world.size() - 1;
+    int failures = 0;
+
+    // Large variable-length broadcasts from different roots.
+    std::string first = rank == 0 ? std::string(1000, 'a') : std::string();
+    std::string second = rank == last ? std::string(2000, 'b') : std::string();
+    mpicxx::request first_done = world.ibcast(first, 0);
+    mpicxx::request second_done = world.ibcast(second, last);
+    first_done.wait();
+    second_done.wait();
+    failures += first != std::string(1000, 'a');
+    failures += second != std::string(2000, 'b');
+
+    // A large broadcast and a serialized gather, each started before the
+    // other completes.
+    std::vector<std::string> names;
+    std::string big = rank == 0 ? std::string(4000, 'c') : std::string();
+    mpicxx::request broadcast = world.ibcast(big, 0);
+    mpicxx::request gathered = world.igatherv_serialized(std::string(rank + 1, 'n'), names, 0);
+    broadcast.wait();
+    gathered.wait();
+    if (rank == 0)
+    {
+        failures += names.size() != std::size_t(last + 1);
+        for (std::size_t i = 0; i < names.size(); ++i)
+        {
+            failures += names[i] != std::string(i + 1, 'n');
+        }
+    }
+    failures += big != std::string(4000, 'c');
+
+    // A large broadcast followed by a pipelined reduction.
+    std::string text = rank == last ? std::string(3000, 'd') : std::string();
+    std::vector<int> ones(64, 1);
+    mpicxx::request text_done = world.ibcast(text, last);
+    mpicxx::request ones_done = world.iallreduce_pipelined(ones.data(), ones.size(), mpicxx::op::sum(), 16, nullptr);
+    text_done.wait();
+    ones_done.wait();
+    failures += text != std::string(3000, 'd');
+    for (int value : ones)
+    {
+        failures += value != last + 1;
+    }
+
+    // Pipelined reductions may be advanced in any order: rank 0 tests them
+    // in the opposite order from the other ranks.
+    std::vector<int> small(32, 1);
+    std::vector<int> large(32, 100);
+    mpicxx::request small_done = world.iallreduce_pipelined(small.data(), small.size(), mpicxx::op::sum(), 8, nullptr);
+    mpicxx::request large_done = world.iallreduce_pipelined(large.data(), large.size(), mpicxx::op::sum(), 8, nullptr);
+    mpicxx::request &tested_first = rank == 0 ? large_done : small_done;
+    mpicxx::request &tested_second = rank == 0 ? small_done : large_done;
+    bool first_complete = false;
+    bool second_complete = false;
+    while (!first_complete || !second_complete)
+    {
+        first_complete = first_complete || tested_first.test();
+        second_complete = second_complete || tested_second.test();
+    }
+    for (std::size_t i = 0; i < small.size(); ++i)
+    {
+        failures += small[i] != last + 1;
+        failures += large[i] != 100 * (last + 1);
+    }
+
+    if (failures != 0)
+    {
+        std::fprintf(stderr, "rank %d: %d multi-phase results wrong\n", rank, failures);
+        return 1;
+    }
+    if (rank == 0)
+    {
+        std::printf("multi-phase collectives ok\n");
+    }
+}
@@ -3,21 +3,192 @@
 #pragma once
 
 #include <mpi.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <vector>
 #include <array>
+#include <string>
+#include <type_traits>
+#include <utility>
 
+#include "datatype/datatype.hpp"
+#include "error/exception.hpp"
+#include "handles/message.hpp"
+#include "handles/owning_request.hpp"
+#include "handles/partitioned_request.hpp"
 #include "handles/request.hpp"
+#include "handles/status.hpp"
+#include "instrumentation/instrumentation.hpp"
 #include "reductionoperation/reductionop.hpp"
+#include "serialization/serialization.hpp"
 
 
 namespace mpicxx
 {
+    namespace details
+    {
+        // Selects the large-count overloads for any integral count type other
+        // than int, so int arguments keep resolving to the plain wrappers.
+        template <class Count>
+        using enable_if_large_count = std::enable_if_t<
+            std::is_integral<Count>::value && !std::is_same<Count, int>::value,
+            int>;
+
+        // Accepts op lvalues and rvalues alike, so forwarding overloads can
+        // tell whether they may take ownership.
+        template <class Op>
+        using enable_if_op = std::enable_if_t<std::is_same<std::decay_t<Op>, op>::value, int>;
+
+        // Counts that have no large-count fallback are rejected rather than
+        // silently narrowed.
+        int checked_count(std::size_t count);
+    }
+
     class comm
     {
         MPI_Comm implementation;
         bool owned;
 
+        request isend_count(
+            void const *buf,
+            std::size_t count,
+            datatype const &datatype_arg,
+            int dest,
+            int tag) const;
+        request irecv_count(
+            void *buf,
+            std::size_t count,
+            datatype const &datatype_arg,
+            int source,
+            int tag) const;
+        request iallreduce_count(
+            void const *sendbuf,
+            void *recvbuf,
+            std::size_t count,
+            datatype const &datatype_arg,
+            op const &op_arg) const;
+        request ibcast_count(
+            void *buf,
+            std::size_t count,
+            datatype const &datatype_arg,
+            int root) const;
+        request ialltoall_count(
+            void const *sendbuf,
+            void *recvbuf,
+            std::size_t count,
+            datatype const &datatype_arg) const;
+        request iallgather_count(
+            void const *sendbuf,
+            void *recvbuf,
+            std::size_t count,
+            datatype const &datatype_arg) const;
+        request ireduce_count(
+            void const *sendbuf,
+            void *recvbuf,
+            std::size_t count,
+            datatype const &datatype_arg,
+            op const &op_arg,
+            int root) const;
+        request iscan_count(
+            void const *sendbuf,
+            void *recvbuf,
+            std::size_t count,
+            datatype const &datatype_arg,
+            op const &op_arg) const;
+        request iexscan_count(
+            void const *sendbuf,
+            void *recvbuf,
+            std::size_t count,
+            datatype const &datatype_arg,
+            op const &op_arg) const;
+        request igatherv_count(
+            void const *sendbuf,
+            std::size_t send_count,
+            void *recvbuf,
+            std::vector<std::size_t> const &recv_counts,
+            std::vector<std::size_t> const &recv_displs,
+            datatype const &datatype_arg,
+            int root) const;
+        request iscatterv_count(
+            void const *sendbuf,
+            std::vector<std::size_t> const &send_counts,
+            std::vector<std::size_t> const &send_displs,
+            void *recvbuf,
+            std::size_t recv_count,
+            datatype const &datatype_arg,
+            int root) const;
+        request iallgatherv_count(
+            void const *sendbuf,
+            std::size_t send_count,
+            void *recvbuf,
+            std::vector<std::size_t> const &recv_counts,
+            std::vector<std::size_t> const &recv_displs,
+            datatype const &datatype_arg) const;
+        request ialltoallv_count(
+            void const *sendbuf,
+            std::vector<std::size_t> const &send_counts,
+            std::vector<std::size_t> const &send_displs,
+            void *recvbuf,
+            std::vector<std::size_t> const &recv_counts,
+            std::vector<std::size_t> const &recv_displs,
+            datatype const &datatype_arg) const;
+        request iallreduce_segmented(
+            void const *sendbuf,
+            void *recvbuf,
+            std::size_t count,
+            datatype const &datatype_arg,
+            op op_arg,
+            std::size_t segment,
+            std::function<void(std::size_t, std::size_t)> on_segment,
+            int depth) const;
+        request ibcast_any_size(
+            void *buf,
+            std::size_t count,
+            datatype const &datatype_arg,
+            std::function<void *(std::size_t)> resize,
+            std::function<void()> done,
+            int root) const;
+        request isend_packed(
+            std::vector<char> packed,
+            int dest,
+            int tag) const;
+        request imrecv_packed(
+            message &message_arg,
+            status const &status_arg,
+            std::function<void(std::vector<char> const &)> done) const;
+        request igatherv_packed(
+            std::vector<char> packed,
+            std::function<void(std::vector<char> const &, std::vector<std::size_t> const &)> done,
+            int root) const;
+        persistent_request send_init_count(
+            void const *buf,
+            std::size_t count,
+            datatype const &datatype_arg,
+            int dest,
+            int tag) const;
+        persistent_request recv_init_count(
+            void *buf,
+            std::size_t count,
+            datatype const &datatype_arg,
+            int source,
+            int tag) const;
+        static std::size_t partition_count(std::size_t size, int partitions);
+        static std::size_t block_count(std::size_t size, int ranks);
+#if MPI_VERSION < 4
+        std::vector<MPI_Request> partition_requests(
+            void const *buf,
+            int partitions,
+            std::size_t count,
+            datatype const &datatype_arg,
+            int peer,
+            int tag,
+            bool receiving) const;
+#endif
+
     public:
+        static constexpr std::size_t eager_bcast_bytes = 240;
+
         constexpr comm(
             MPI_Comm implementation_arg,
             bool owned_arg)
@@ -40,19 +211,22 @@ namespace mpicxx
         ~comm();
         int size() const;
         int rank() const;
+        void set_name(std::string const &name_arg);
+        std::string name() const;
         request iallreduce(
             void const *sendbuf,
             void *recvbuf,
             int count,
             datatype const &datatype_arg,
-            op const &op_arg);
+            op const &op_arg) const;
         template <class T>
         request iallreduce(
             T const *sendbuf,
             T *recvbuf,
             int count,
-            op const &op_arg)
+            op const &op_arg) const
         {
+            MPICXX_INSTRUMENT("iallreduce", implementation, std::size_t(count), predefined_datatype<T>().get());
             datatype datatype_arg = predefined_datatype<T>();
             MPI_Request request_implementation;
             handle_error(
@@ -70,8 +244,9 @@ namespace mpicxx
         request iallreduce(
             T *buf,
             int count,
-            op const &op_arg)
+            op const &op_arg) const
         {
+            MPICXX_INSTRUMENT("iallreduce", implementation, std::size_t(count), predefined_datatype<T>().get());
             datatype datatype_arg = predefined_datatype<T>();
             MPI_Request request_implementation;
             handle_error(
@@ -85,19 +260,250 @@ namespace mpicxx
                     &request_implementation));
             return request(request_implementation);
         }
+        request ialltoall(
+            void const *sendbuf,
+            void *recvbuf,
+            int count,
+            datatype const &datatype_arg) const;
+        template <class T>
+        request ialltoall(
+            T const *sendbuf,
+            T *recvbuf,
+            int count) const
+        {
+            return ialltoall(sendbuf, recvbuf, count, predefined_datatype<T>());
+        }
+        template <class T>
+        request ialltoall(
+            T *buf,
+            int count) const
+        {
+            return ialltoall(MPI_IN_PLACE, buf, count, predefined_datatype<T>());
+        }
+        request ialltoallv(
+            void const *sendbuf,
+            int const send_counts[],
+            int const send_displs[],
+            void *recvbuf,
+            int const recv_counts[],
+            int const recv_displs[],
+            datatype const &datatype_arg) const;
+        template <class T>
+        request ialltoallv(
+            T const *sendbuf,
+            int const send_counts[],
+            int const send_displs[],
+            T *recvbuf,
+            int const recv_counts[],
+            int const recv_displs[]) const
+        {
+            return ialltoallv(sendbuf, send_counts, send_displs, recvbuf, recv_counts, recv_displs, predefined_datatype<T>());
+        }
+        template <class T>
+        request ialltoallv(
+            T *buf,
+            int const counts[],
+            int const displs[]) const
+        {
+            return ialltoallv(MPI_IN_PLACE, nullptr, nullptr, buf, counts, displs, predefined_datatype<T>());
+        }
+        request ialltoallw(
+            void const *sendbuf,
+            std::vector<int> const &send_counts,
+            std::vector<int> const &send_displs,
+            std::vector<MPI_Datatype> const &send_types,
+            void *recvbuf,
+            std::vector<int> const &recv_counts,
+            std::vector<int> const &recv_displs,
+            std::vector<MPI_Datatype> const &recv_types) const;
+        request iallgather(
+            void const *sendbuf,
+            void *recvbuf,
+            int count,
+            datatype const &datatype_arg) const;
+        template <class T>
+        request iallgather(
+            T const *sendbuf,
+            T *recvbuf,
+            int count) const
+        {
+            return iallgather(sendbuf, recvbuf, count, predefined_datatype<T>());
+        }
+        // In place: this rank's count elements already sit at offset
+        // rank() * count of buf.
+        template <class T>
+        request iallgather(
+            T *buf,
+            int count) const
+        {
+            return iallgather(MPI_IN_PLACE, buf, count, predefined_datatype<T>());
+        }
+        request iallgatherv(
+            void const *sendbuf,
+            int send_count,
+            void *recvbuf,
+            int const recv_counts[],
+            int const recv_displs[],
+            datatype const &datatype_arg) const;
+        template <class T>
+        request iallgatherv(
+            T const *sendbuf,
+            int send_count,
+            T *recvbuf,
+            int const recv_counts[],
+            int const recv_displs[]) const
+        {
+            return iallgatherv(sendbuf, send_count, recvbuf, recv_counts, recv_displs, predefined_datatype<T>());
+        }
+        template <class T>
+        request iallgatherv(
+            T *buf,
+            int const recv_counts[],
+            int const recv_displs[]) const
+        {
+            return iallgatherv(MPI_IN_PLACE, 0, buf, recv_counts, recv_displs, predefined_datatype<T>());
+        }
+        request ireduce(
+            void const *sendbuf,
+            void *recvbuf,
+            int count,
+            datatype const &datatype_arg,
+            op const &op_arg,
+            int root) const;
+        template <class T>
+        request ireduce(
+            T const *sendbuf,
+            T *recvbuf,
+            int count,
+            op const &op_arg,
+            int root) const
+        {
+            return ireduce(sendbuf, recvbuf, count, predefined_datatype<T>(), op_arg, root);
+        }
+        // In place: the result replaces buf on root; buf is only read
+        // elsewhere.
+        template <class T>
+        request ireduce(
+            T *buf,
+            int count,
+            op const &op_arg,
+            int root) const
+        {
+            if (rank() == root)
+            {
+                return ireduce(MPI_IN_PLACE, buf, count, predefined_datatype<T>(), op_arg, root);
+            }
+            return ireduce(buf, nullptr, count, predefined_datatype<T>(), op_arg, root);
+        }
+        request ireduce_scatter(
+            void const *sendbuf,
+            void *recvbuf,
+            int const recv_counts[],
+            datatype const &datatype_arg,
+            op const &op_arg) const;
+        template <class T>
+        request ireduce_scatter(
+            T const *sendbuf,
+            T *recvbuf,
+            int const recv_counts[],
+            op const &op_arg) const
+        {
+            return ireduce_scatter(sendbuf, recvbuf, recv_counts, predefined_datatype<T>(), op_arg);
+        }
+        // In place: this rank's block of the result is left at the start of
+        // buf.
+        template <class T>
+        request ireduce_scatter(
+            T *buf,
+            int const recv_counts[],
+            op const &op_arg) const
+        {
+            return ireduce_scatter(MPI_IN_PLACE, buf, recv_counts, predefined_datatype<T>(), op_arg);
+        }
+        request ireduce_scatter_block(
+            void const *sendbuf,
+            void *recvbuf,
+            int recv_count,
+            datatype const &datatype_arg,
+            op const &op_arg) const;
+        template <class T>
+        request ireduce_scatter_block(
+            T const *sendbuf,
+            T *recvbuf,
+            int recv_count,
+            op const &op_arg) const
+        {
+            return ireduce_scatter_block(sendbuf, recvbuf, recv_count, predefined_datatype<T>(), op_arg);
+        }
+        template <class T>
+        request ireduce_scatter_block(
+            T *buf,
+            int recv_count,
+            op const &op_arg) const
+        {
+            return ireduce_scatter_block(MPI_IN_PLACE, buf, recv_count, predefined_datatype<T>(), op_arg);
+        }
+        request iscan(
+            void const *sendbuf,
+            void *recvbuf,
+            int count,
+            datatype const &datatype_arg,
+            op const &op_arg) const;
+        template <class T>
+        request iscan(
+            T const *sendbuf,
+            T *recvbuf,
+            int count,
+            op const &op_arg) const
+        {
+            return iscan(sendbuf, recvbuf, count, predefined_datatype<T>(), op_arg);
+        }
+        template <class T>
+        request iscan(
+            T *buf,
+            int count,
+            op const &op_arg) const
+        {
+            return iscan(MPI_IN_PLACE, buf, count, predefined_datatype<T>(), op_arg);
+        }
+        // The result on rank 0 is undefined and left untouched.
+        request iexscan(
+            void const *sendbuf,
+            void *recvbuf,
+            int count,
+            datatype const &datatype_arg,
+            op const &op_arg) const;
+        template <class T>
+        request iexscan(
+            T const *sendbuf,
+            T *recvbuf,
+            int count,
+            op const &op_arg) const
+        {
+            return iexscan(sendbuf, recvbuf, count, predefined_datatype<T>(), op_arg);
+        }
+        template <class T>
+        request iexscan(
+            T *buf,
+            int count,
+            op const &op_arg) const
+        {
+            return iexscan(MPI_IN_PLACE, buf, count, predefined_datatype<T>(), op_arg);
+        }
         request isend(
             void const *buf,
             int count,
             datatype datatype_arg,
             int dest,
-            int tag);
+            int tag) const;
         template <class T>
         request isend(
             T const *buf,
             int count,
             int dest,
-            int tag)
+            int tag) const
         {
+            MPICXX_INSTRUMENT("isend", implementation, std::size_t(count), predefined_datatype<T>().get());
             datatype datatype_arg = predefined_datatype<T>();
             MPI_Request request_implementation;
             handle_error(
@@ -116,14 +522,15 @@ namespace mpicxx
             int count,
             datatype datatype_arg,
             int dest,
-            int tag);
+            int tag) const;
         template <class T>
         request irecv(
             T *buf,
             int count,
             int dest,
-            int tag)
+            int tag) const
         {
+            MPICXX_INSTRUMENT("irecv", implementation, std::size_t(count), predefined_datatype<T>().get());
             datatype datatype_arg = predefined_datatype<T>();
             MPI_Request request_implementation;
             handle_error(
@@ -138,92 +545,847 @@ namespace mpicxx
             return request(request_implementation);
         }
 
-        template <typename VT>
-        request ibcast(VT &buffer, int root) const
+        // Large-count overloads. Counts above INT_MAX use the MPI-4 "_c"
+        // functions when available, otherwise a derived datatype spanning the
+        // whole buffer (point-to-point, bcast) or each rank's block (alltoall,
+        // allgather), or several in-flight chunks completed by one request
+        // (reductions and scans).
+        template <class Count, details::enable_if_large_count<Count> = 0>
+        request isend(
+            void const *buf,
+            Count count,
+            datatype const &datatype_arg,
+            int dest,
+            int tag) const
         {
-            MPI_Request request_implementation;
-            handle_error(
-                MPI_Ibcast(
-                    &buffer,
-                    1,
-                    predefined_datatype<VT>().get(),
-                    root,
-                    implementation,
-                    &request_implementation));
-            return request(request_implementation);
+            return isend_count(buf, std::size_t(count), datatype_arg, dest, tag);
         }
-
-        request ibcast(std::string& buffer, int root) const
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        request isend(
+            T const *buf,
+            Count count,
+            int dest,
+            int tag) const
         {
-            int size;
-            if (rank() == root)
-            {
-                size = buffer.size();
-            }
-            ibcast(size, root);
-            if (rank() != root)
-            {
-                buffer.resize(size);
-            }
-            MPI_Request request_implementation;
-            handle_error(MPI_Ibcast(buffer.data(), size, MPI_CHAR, root,
-                                    implementation, &request_implementation));
-            return request(request_implementation);
+            return isend_count(buf, std::size_t(count), predefined_datatype<T>(), dest, tag);
         }
-
-        template <typename VT>
-        request ibcast(std::vector<VT> &buffer, int root) const
+        template <class Count, details::enable_if_large_count<Count> = 0>
+        request irecv(
+            void *buf,
+            Count count,
+            datatype const &datatype_arg,
+            int source,
+            int tag) const
         {
-            MPI_Request request_implementation;
-            handle_error(
-                MPI_Ibcast(
-                    buffer.data(),
-                    buffer.size(),
-                    predefined_datatype<VT>().get(),
-                    root,
-                    implementation,
-                    &request_implementation));
-            return request(request_implementation);
+            return irecv_count(buf, std::size_t(count), datatype_arg, source, tag);
         }
-
-        template <typename VT, size_t N>
-        request ibcast(std::array<VT, N> &buffer, int root) const
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        request irecv(
+            T *buf,
+            Count count,
+            int source,
+            int tag) const
         {
-            MPI_Request request_implementation;
-            handle_error(
-                MPI_Ibcast(
-                    buffer.data(),
-                    buffer.size(),
-                    predefined_datatype<VT>().get(),
-                    root,
-                    implementation,
-                    &request_implementation));
-            return request(request_implementation);
+            return irecv_count(buf, std::size_t(count), predefined_datatype<T>(), source, tag);
         }
-
-        template <typename VT>
-        request iscatterv(std::vector<VT> &send_buffer, std::vector<int> &send_counts, std::vector<int> &displacements, std::vector<VT> &receive_buffer, int root) const
+        template <class Count, details::enable_if_large_count<Count> = 0>
+        request iallreduce(
+            void const *sendbuf,
+            void *recvbuf,
+            Count count,
+            datatype const &datatype_arg,
+            op const &op_arg) const
         {
-            MPI_Request request_implementation;
-            handle_error(
-                MPI_Iscatterv(
-                    send_buffer.data(),
-                    send_counts.data(),
-                    displacements.data(),
-                    predefined_datatype<VT>().get(),
-                    receive_buffer.data(),
-                    receive_buffer.size(),
-                    predefined_datatype<VT>().get(),
-                    root,
-                    implementation,
-                    &request_implementation));
-            return request(request_implementation);
+            return iallreduce_count(sendbuf, recvbuf, std::size_t(count), datatype_arg, op_arg);
         }
-
-        template <typename VT>
-        request igather(VT &send_buffer, std::vector<VT> &receive_buffer, int root) const
-        {
-            MPI_Request request_implementation;
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        request iallreduce(
+            T const *sendbuf,
+            T *recvbuf,
+            Count count,
+            op const &op_arg) const
+        {
+            return iallreduce_count(sendbuf, recvbuf, std::size_t(count), predefined_datatype<T>(), op_arg);
+        }
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        request iallreduce(
+            T *buf,
+            Count count,
+            op const &op_arg) const
+        {
+            return iallreduce_count(MPI_IN_PLACE, buf, std::size_t(count), predefined_datatype<T>(), op_arg);
+        }
+        template <class Count, details::enable_if_large_count<Count> = 0>
+        request ibcast(
+            void *buf,
+            Count count,
+            datatype const &datatype_arg,
+            int root) const
+        {
+            return ibcast_count(buf, std::size_t(count), datatype_arg, root);
+        }
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        request ibcast(
+            T *buf,
+            Count count,
+            int root) const
+        {
+            return ibcast_count(buf, std::size_t(count), predefined_datatype<T>(), root);
+        }
+        template <class Count, details::enable_if_large_count<Count> = 0>
+        request ialltoall(
+            void const *sendbuf,
+            void *recvbuf,
+            Count count,
+            datatype const &datatype_arg) const
+        {
+            return ialltoall_count(sendbuf, recvbuf, std::size_t(count), datatype_arg);
+        }
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        request ialltoall(
+            T const *sendbuf,
+            T *recvbuf,
+            Count count) const
+        {
+            return ialltoall_count(sendbuf, recvbuf, std::size_t(count), predefined_datatype<T>());
+        }
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        request ialltoall(
+            T *buf,
+            Count count) const
+        {
+            return ialltoall_count(MPI_IN_PLACE, buf, std::size_t(count), predefined_datatype<T>());
+        }
+        template <class Count, details::enable_if_large_count<Count> = 0>
+        request iallgather(
+            void const *sendbuf,
+            void *recvbuf,
+            Count count,
+            datatype const &datatype_arg) const
+        {
+            return iallgather_count(sendbuf, recvbuf, std::size_t(count), datatype_arg);
+        }
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        request iallgather(
+            T const *sendbuf,
+            T *recvbuf,
+            Count count) const
+        {
+            return iallgather_count(sendbuf, recvbuf, std::size_t(count), predefined_datatype<T>());
+        }
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        request iallgather(
+            T *buf,
+            Count count) const
+        {
+            return iallgather_count(MPI_IN_PLACE, buf, std::size_t(count), predefined_datatype<T>());
+        }
+        template <class Count, details::enable_if_large_count<Count> = 0>
+        request ireduce(
+            void const *sendbuf,
+            void *recvbuf,
+            Count count,
+            datatype const &datatype_arg,
+            op const &op_arg,
+            int root) const
+        {
+            return ireduce_count(sendbuf, recvbuf, std::size_t(count), datatype_arg, op_arg, root);
+        }
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        request ireduce(
+            T const *sendbuf,
+            T *recvbuf,
+            Count count,
+            op const &op_arg,
+            int root) const
+        {
+            return ireduce_count(sendbuf, recvbuf, std::size_t(count), predefined_datatype<T>(), op_arg, root);
+        }
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        request ireduce(
+            T *buf,
+            Count count,
+            op const &op_arg,
+            int root) const
+        {
+            if (rank() == root)
+            {
+                return ireduce_count(MPI_IN_PLACE, buf, std::size_t(count), predefined_datatype<T>(), op_arg, root);
+            }
+            return ireduce_count(buf, nullptr, std::size_t(count), predefined_datatype<T>(), op_arg, root);
+        }
+        template <class Count, details::enable_if_large_count<Count> = 0>
+        request iscan(
+            void const *sendbuf,
+            void *recvbuf,
+            Count count,
+            datatype const &datatype_arg,
+            op const &op_arg) const
+        {
+            return iscan_count(sendbuf, recvbuf, std::size_t(count), datatype_arg, op_arg);
+        }
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        request iscan(
+            T const *sendbuf,
+            T *recvbuf,
+            Count count,
+            op const &op_arg) const
+        {
+            return iscan_count(sendbuf, recvbuf, std::size_t(count), predefined_datatype<T>(), op_arg);
+        }
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        request iscan(
+            T *buf,
+            Count count,
+            op const &op_arg) const
+        {
+            return iscan_count(MPI_IN_PLACE, buf, std::size_t(count), predefined_datatype<T>(), op_arg);
+        }
+        template <class Count, details::enable_if_large_count<Count> = 0>
+        request iexscan(
+            void const *sendbuf,
+            void *recvbuf,
+            Count count,
+            datatype const &datatype_arg,
+            op const &op_arg) const
+        {
+            return iexscan_count(sendbuf, recvbuf, std::size_t(count), datatype_arg, op_arg);
+        }
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        request iexscan(
+            T const *sendbuf,
+            T *recvbuf,
+            Count count,
+            op const &op_arg) const
+        {
+            return iexscan_count(sendbuf, recvbuf, std::size_t(count), predefined_datatype<T>(), op_arg);
+        }
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        request iexscan(
+            T *buf,
+            Count count,
+            op const &op_arg) const
+        {
+            return iexscan_count(MPI_IN_PLACE, buf, std::size_t(count), predefined_datatype<T>(), op_arg);
+        }
+        // Segmented (pipelined) reductions and broadcasts. The buffer is split
+        // into segments of segment elements with up to depth of them in
+        // flight. on_segment(offset, count) runs, in order, for each segment
+        // as the wait or test that completes it is called, after the next
+        // segment has been started, so consuming segment k overlaps with the
+        // transfer of the following ones. Each request duplicates the
+        // communicator with a nonblocking MPI_Comm_idup when it is started
+        // and runs its segments there, so outstanding pipelined requests may
+        // be completed in any order; the call itself, like any collective,
+        // must be made in the same order on every rank. The duplicate costs
+        // one extra collective per request, so pipelining pays off only for
+        // buffers of many segments. The request keeps its own duplicate of
+        // the datatype. MPI ops cannot be duplicated: an op passed as an rvalue
+        // is moved into the request, while an lvalue op must stay alive
+        // until the request completes.
+        request iallreduce_pipelined(
+            void const *sendbuf,
+            void *recvbuf,
+            std::size_t count,
+            datatype const &datatype_arg,
+            op const &op_arg,
+            std::size_t segment,
+            std::function<void(std::size_t, std::size_t)> on_segment,
+            int depth = 2) const;
+        request iallreduce_pipelined(
+            void const *sendbuf,
+            void *recvbuf,
+            std::size_t count,
+            datatype const &datatype_arg,
+            op &&op_arg,
+            std::size_t segment,
+            std::function<void(std::size_t, std::size_t)> on_segment,
+            int depth = 2) const;
+        template <class T, class Op, details::enable_if_op<Op> = 0>
+        request iallreduce_pipelined(
+            T const *sendbuf,
+            T *recvbuf,
+            std::size_t count,
+            Op &&op_arg,
+            std::size_t segment,
+            std::function<void(std::size_t, std::size_t)> on_segment,
+            int depth = 2) const
+        {
+            return iallreduce_pipelined(sendbuf, recvbuf, count, predefined_datatype<T>(), std::forward<Op>(op_arg), segment, std::move(on_segment), depth);
+        }
+        template <class T, class Op, details::enable_if_op<Op> = 0>
+        request iallreduce_pipelined(
+            T *buf,
+            std::size_t count,
+            Op &&op_arg,
+            std::size_t segment,
+            std::function<void(std::size_t, std::size_t)> on_segment,
+            int depth = 2) const
+        {
+            return iallreduce_pipelined(MPI_IN_PLACE, buf, count, predefined_datatype<T>(), std::forward<Op>(op_arg), segment, std::move(on_segment), depth);
+        }
+        request ibcast_pipelined(
+            void *buf,
+            std::size_t count,
+            datatype const &datatype_arg,
+            int root,
+            std::size_t segment,
+            std::function<void(std::size_t, std::size_t)> on_segment,
+            int depth = 2) const;
+        template <class T>
+        request ibcast_pipelined(
+            T *buf,
+            std::size_t count,
+            int root,
+            std::size_t segment,
+            std::function<void(std::size_t, std::size_t)> on_segment,
+            int depth = 2) const
+        {
+            return ibcast_pipelined(buf, count, predefined_datatype<T>(), root, segment, std::move(on_segment), depth);
+        }
+        template <class Count, details::enable_if_large_count<Count> = 0>
+        persistent_request send_init(
+            void const *buf,
+            Count count,
+            datatype const &datatype_arg,
+            int dest,
+            int tag) const
+        {
+            return send_init_count(buf, std::size_t(count), datatype_arg, dest, tag);
+        }
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        persistent_request send_init(
+            T const *buf,
+            Count count,
+            int dest,
+            int tag) const
+        {
+            return send_init_count(buf, std::size_t(count), predefined_datatype<T>(), dest, tag);
+        }
+        template <class Count, details::enable_if_large_count<Count> = 0>
+        persistent_request recv_init(
+            void *buf,
+            Count count,
+            datatype const &datatype_arg,
+            int source,
+            int tag) const
+        {
+            return recv_init_count(buf, std::size_t(count), datatype_arg, source, tag);
+        }
+        template <class T, class Count, details::enable_if_large_count<Count> = 0>
+        persistent_request recv_init(
+            T *buf,
+            Count count,
+            int source,
+            int tag) const
+        {
+            return recv_init_count(buf, std::size_t(count), predefined_datatype<T>(), source, tag);
+        }
+        persistent_request send_init(
+            void const *buf,
+            int count,
+            datatype const &datatype_arg,
+            int dest,
+            int tag) const;
+        template <class T>
+        persistent_request send_init(
+            T const *buf,
+            int count,
+            int dest,
+            int tag) const
+        {
+            datatype datatype_arg = predefined_datatype<T>();
+            MPI_Request request_implementation;
+            handle_error(
+                MPI_Send_init(
+                    buf,
+                    count,
+                    datatype_arg.get(),
+                    dest,
+                    tag,
+                    implementation,
+                    &request_implementation));
+            return persistent_request(request_implementation);
+        }
+        persistent_request recv_init(
+            void *buf,
+            int count,
+            datatype const &datatype_arg,
+            int source,
+            int tag) const;
+        template <class T>
+        persistent_request recv_init(
+            T *buf,
+            int count,
+            int source,
+            int tag) const
+        {
+            datatype datatype_arg = predefined_datatype<T>();
+            MPI_Request request_implementation;
+            handle_error(
+                MPI_Recv_init(
+                    buf,
+                    count,
+                    datatype_arg.get(),
+                    source,
+                    tag,
+                    implementation,
+                    &request_implementation));
+            return persistent_request(request_implementation);
+        }
+        // Partitioned point-to-point with partitions parts of count elements
+        // each; see partitioned_request for the pre-MPI-4 emulation.
+        partitioned_request psend_init(
+            void const *buf,
+            int partitions,
+            std::size_t count,
+            datatype const &datatype_arg,
+            int dest,
+            int tag,
+            MPI_Info info = MPI_INFO_NULL) const;
+        partitioned_request precv_init(
+            void *buf,
+            int partitions,
+            std::size_t count,
+            datatype const &datatype_arg,
+            int source,
+            int tag,
+            MPI_Info info = MPI_INFO_NULL) const;
+        // The vector is split into partitions equal parts, so its size must
+        // be a multiple of partitions.
+        template <class T>
+        partitioned_buffer<T> psend_init(
+            std::vector<T> &&buffer,
+            int partitions,
+            int dest,
+            int tag) const
+        {
+            std::size_t count = partition_count(buffer.size(), partitions);
+            partitioned_request started = psend_init(buffer.data(), partitions, count, predefined_datatype<T>(), dest, tag);
+            return partitioned_buffer<T>(std::move(buffer), partitions, std::move(started));
+        }
+        template <class T>
+        partitioned_buffer<T> precv_init(
+            std::vector<T> &&buffer,
+            int partitions,
+            int source,
+            int tag) const
+        {
+            std::size_t count = partition_count(buffer.size(), partitions);
+            partitioned_request started = precv_init(buffer.data(), partitions, count, predefined_datatype<T>(), source, tag);
+            return partitioned_buffer<T>(std::move(buffer), partitions, std::move(started));
+        }
+#if MPI_VERSION >= 4
+        persistent_request allreduce_init(
+            void const *sendbuf,
+            void *recvbuf,
+            int count,
+            datatype const &datatype_arg,
+            op const &op_arg,
+            MPI_Info info = MPI_INFO_NULL) const;
+        template <class T>
+        persistent_request allreduce_init(
+            T const *sendbuf,
+            T *recvbuf,
+            int count,
+            op const &op_arg,
+            MPI_Info info = MPI_INFO_NULL) const
+        {
+            datatype datatype_arg = predefined_datatype<T>();
+            MPI_Request request_implementation;
+            handle_error(
+                MPI_Allreduce_init(
+                    sendbuf,
+                    recvbuf,
+                    count,
+                    datatype_arg.get(),
+                    op_arg.get(),
+                    implementation,
+                    info,
+                    &request_implementation));
+            return persistent_request(request_implementation);
+        }
+        template <class T>
+        persistent_request allreduce_init(
+            T *buf,
+            int count,
+            op const &op_arg,
+            MPI_Info info = MPI_INFO_NULL) const
+        {
+            datatype datatype_arg = predefined_datatype<T>();
+            MPI_Request request_implementation;
+            handle_error(
+                MPI_Allreduce_init(
+                    MPI_IN_PLACE,
+                    buf,
+                    count,
+                    datatype_arg.get(),
+                    op_arg.get(),
+                    implementation,
+                    info,
+                    &request_implementation));
+            return persistent_request(request_implementation);
+        }
+        persistent_request bcast_init(
+            void *buf,
+            int count,
+            datatype const &datatype_arg,
+            int root,
+            MPI_Info info = MPI_INFO_NULL) const;
+        template <class T>
+        persistent_request bcast_init(
+            T *buf,
+            int count,
+            int root,
+            MPI_Info info = MPI_INFO_NULL) const
+        {
+            datatype datatype_arg = predefined_datatype<T>();
+            MPI_Request request_implementation;
+            handle_error(
+                MPI_Bcast_init(
+                    buf,
+                    count,
+                    datatype_arg.get(),
+                    root,
+                    implementation,
+                    info,
+                    &request_implementation));
+            return persistent_request(request_implementation);
+        }
+        template <typename VT>
+        persistent_request bcast_init(std::vector<VT> &buffer, int root, MPI_Info info = MPI_INFO_NULL) const
+        {
+            return bcast_init(buffer.data(), details::checked_count(buffer.size()), root, info);
+        }
+#endif
+
+        status probe(int source, int tag) const;
+        bool iprobe(int source, int tag, status &status_arg) const;
+        message mprobe(int source, int tag, status &status_arg) const;
+        bool improbe(int source, int tag, message &message_arg, status &status_arg) const;
+        request imrecv(
+            void *buf,
+            int count,
+            datatype const &datatype_arg,
+            message &message_arg) const;
+        template <class T>
+        request imrecv(
+            T *buf,
+            int count,
+            message &message_arg) const
+        {
+            return imrecv(buf, count, predefined_datatype<T>(), message_arg);
+        }
+        // Blocks in MPI_Mprobe until a matching message is available, sizes
+        // the vector exactly from its element count and starts the receive.
+        template <class T>
+        request irecv_any_size(
+            std::vector<T> &buffer,
+            int source,
+            int tag) const
+        {
+            status status_arg;
+            message message_arg = mprobe(source, tag, status_arg);
+            return imrecv_resized(buffer, message_arg, status_arg);
+        }
+        // Receives an already matched message into an exactly sized vector.
+        template <class T>
+        request imrecv_resized(
+            std::vector<T> &buffer,
+            message &message_arg,
+            status const &status_arg) const
+        {
+            datatype datatype_arg = predefined_datatype<T>();
+            int count = status_arg.get_count(datatype_arg);
+            if (count == MPI_UNDEFINED)
+            {
+                throw exception("mpicxx: probed message is not a whole number of elements");
+            }
+            buffer.resize(count);
+            return imrecv(buffer.data(), count, datatype_arg, message_arg);
+        }
+
+        template <typename VT>
+        request ibcast(VT &buffer, int root) const
+        {
+            MPICXX_INSTRUMENT("ibcast", implementation, 1, predefined_datatype<VT>().get());
+            MPI_Request request_implementation;
+            handle_error(
+                MPI_Ibcast(
+                    &buffer,
+                    1,
+                    predefined_datatype<VT>().get(),
+                    root,
+                    implementation,
+                    &request_implementation));
+            return request(request_implementation);
+        }
+
+        request ibcast(std::string &buffer, int root) const
+        {
+            return ibcast_any_size(buffer, root);
+        }
+
+        // Variable-length broadcast: non-root buffers are resized to the
+        // root's length when the request completes. Payloads of up to
+        // eager_bcast_bytes travel inline in a single fixed-size header
+        // broadcast; larger ones add a second broadcast on a private
+        // duplicate of this communicator, created collectively on first use.
+        // Every rank, root included, starts that second broadcast from the
+        // wait or test that completes the first, so several large broadcasts
+        // outstanding at once must be completed in the same order on every
+        // rank, whatever their roots; completing them in the order they were
+        // started always satisfies this.
+        request ibcast_any_size(std::string &buffer, int root) const
+        {
+            return ibcast_any_size(
+                &buffer[0],
+                buffer.size(),
+                predefined_datatype<char>(),
+                [&buffer](std::size_t count) -> void *
+                {
+                    buffer.resize(count);
+                    return &buffer[0];
+                },
+                nullptr,
+                root);
+        }
+
+        template <typename VT>
+        request ibcast_any_size(std::vector<VT> &buffer, int root) const
+        {
+            return ibcast_any_size(
+                buffer.data(),
+                buffer.size(),
+                predefined_datatype<VT>(),
+                [&buffer](std::size_t count) -> void *
+                {
+                    buffer.resize(count);
+                    return buffer.data();
+                },
+                nullptr,
+                root);
+        }
+
+        // Transfers of any type with a serializer (see serialization.hpp).
+        // Trivially copyable values and contiguous ranges of them go straight
+        // to and from their own memory; anything else is packed into a single
+        // buffer owned by the request and unpacked when it completes. To read
+        // packed nested containers in place instead, receive the bytes with
+        // irecv_any_size into a std::vector<char> and wrap it in ragged_view.
+        template <class T>
+        request isend_serialized(T const &value, int dest, int tag) const
+        {
+            if constexpr (details::is_contiguous_trivial<T>::value)
+            {
+                return isend_count(
+                    value.data(),
+                    value.size() * sizeof(typename details::contiguous_element<T>::type),
+                    datatype::predefined_byte(),
+                    dest,
+                    tag);
+            }
+            else if constexpr (std::is_trivially_copyable<T>::value)
+            {
+                return isend_count(&value, sizeof(T), datatype::predefined_byte(), dest, tag);
+            }
+            else
+            {
+                return isend_packed(pack(value), dest, tag);
+            }
+        }
+
+        // Contiguous and packed values are matched with MPI_Mprobe first, so
+        // this blocks until a matching message has arrived.
+        template <class T>
+        request irecv_serialized(T &value, int source, int tag) const
+        {
+            if constexpr (std::is_trivially_copyable<T>::value)
+            {
+                return irecv_count(&value, sizeof(T), datatype::predefined_byte(), source, tag);
+            }
+            else
+            {
+                status status_arg;
+                message message_arg = mprobe(source, tag, status_arg);
+                if constexpr (details::is_contiguous_trivial<T>::value)
+                {
+                    using element = typename details::contiguous_element<T>::type;
+                    int bytes = status_arg.get_count(datatype::predefined_byte());
+                    if (bytes % int(sizeof(element)) != 0)
+                    {
+                        throw exception("mpicxx: probed message is not a whole number of elements");
+                    }
+                    value.resize(std::size_t(bytes) / sizeof(element));
+                    return imrecv(value.empty() ? nullptr : &value[0], bytes, datatype::predefined_byte(), message_arg);
+                }
+                else
+                {
+                    return imrecv_packed(
+                        message_arg,
+                        status_arg,
+                        [&value](std::vector<char> const &packed)
+                        {
+                            unpack(packed, value);
+                        });
+                }
+            }
+        }
+
+        // Variable-length broadcast of any serializable value, with the same
+        // eager header and ordering rules as ibcast_any_size.
+        template <class T>
+        request ibcast_serialized(T &value, int root) const
+        {
+            if constexpr (details::is_contiguous_trivial<T>::value)
+            {
+                using element = typename details::contiguous_element<T>::type;
+                return ibcast_any_size(
+                    value.empty() ? nullptr : &value[0],
+                    value.size() * sizeof(element),
+                    datatype::predefined_byte(),
+                    [&value](std::size_t bytes) -> void *
+                    {
+                        value.resize(bytes / sizeof(element));
+                        return value.empty() ? nullptr : &value[0];
+                    },
+                    nullptr,
+                    root);
+            }
+            else if constexpr (std::is_trivially_copyable<T>::value)
+            {
+                return ibcast_count(&value, sizeof(T), datatype::predefined_byte(), root);
+            }
+            else
+            {
+                auto packed = std::make_shared<std::vector<char>>();
+                if (rank() == root)
+                {
+                    pack(value, *packed);
+                }
+                return ibcast_any_size(
+                    packed->data(),
+                    packed->size(),
+                    datatype::predefined_byte(),
+                    [packed](std::size_t bytes) -> void *
+                    {
+                        packed->resize(bytes);
+                        return packed->data();
+                    },
+                    [packed, &value]()
+                    {
+                        unpack(*packed, value);
+                    },
+                    root);
+            }
+        }
+
+        // Gathers one serializable value per rank into values on root, in
+        // rank order. The byte counts are gathered first; every rank starts
+        // the payload gatherv from the wait or test that completes that step,
+        // on the same private communicator as the second phase of
+        // ibcast_any_size. Outstanding gathers and large broadcasts on a
+        // communicator must therefore be completed in the same order on
+        // every rank.
+        template <class T>
+        request igatherv_serialized(T const &value, std::vector<T> &values, int root) const
+        {
+            return igatherv_packed(
+                pack(value),
+                [&values](std::vector<char> const &gathered, std::vector<std::size_t> const &offsets)
+                {
+                    values.resize(offsets.size() - 1);
+                    for (std::size_t i = 0; i < values.size(); ++i)
+                    {
+                        unpack(gathered.data() + offsets[i], offsets[i + 1] - offsets[i], values[i]);
+                    }
+                },
+                root);
+        }
+
+        template <typename VT>
+        request ibcast(std::vector<VT> &buffer, int root) const
+        {
+            return ibcast_count(buffer.data(), buffer.size(), predefined_datatype<VT>(), root);
+        }
+
+        // Overloads taking the vector by move: the request owns the buffer,
+        // so a freshly built one can be sent without copying it or keeping
+        // it alive. Sends free it on completion; receives and broadcasts hand
+        // it back through owning_request::take().
+        template <typename VT>
+        request isend(std::vector<VT> &&buffer, int dest, int tag) const
+        {
+            using continuation_type = details::buffer_continuation<std::vector<VT>>;
+            std::unique_ptr<continuation_type> continuation(new continuation_type(std::move(buffer)));
+            request started = isend_count(
+                continuation->buffer.data(),
+                continuation->buffer.size(),
+                predefined_datatype<VT>(),
+                dest,
+                tag);
+            return request(
+                started.release(),
+                std::unique_ptr<details::request_continuation>(continuation.release()));
+        }
+
+        template <typename VT>
+        owning_request<std::vector<VT>> irecv(std::vector<VT> &&buffer, int source, int tag) const
+        {
+            std::unique_ptr<std::vector<VT>> owned(new std::vector<VT>(std::move(buffer)));
+            request started = irecv_count(owned->data(), owned->size(), predefined_datatype<VT>(), source, tag);
+            return owning_request<std::vector<VT>>(std::move(owned), std::move(started));
+        }
+
+        template <typename VT>
+        owning_request<std::vector<VT>> ibcast(std::vector<VT> &&buffer, int root) const
+        {
+            std::unique_ptr<std::vector<VT>> owned(new std::vector<VT>(std::move(buffer)));
+            request started = ibcast_count(owned->data(), owned->size(), predefined_datatype<VT>(), root);
+            return owning_request<std::vector<VT>>(std::move(owned), std::move(started));
+        }
+
+        template <typename VT, size_t N>
+        request ibcast(std::array<VT, N> &buffer, int root) const
+        {
+            MPICXX_INSTRUMENT("ibcast", implementation, N, predefined_datatype<VT>().get());
+            MPI_Request request_implementation;
+            handle_error(
+                MPI_Ibcast(
+                    buffer.data(),
+                    buffer.size(),
+                    predefined_datatype<VT>().get(),
+                    root,
+                    implementation,
+                    &request_implementation));
+            return request(request_implementation);
+        }
+
+        template <typename VT>
+        request iscatterv(std::vector<VT> &send_buffer, std::vector<int> &send_counts, std::vector<int> &displacements, std::vector<VT> &receive_buffer, int root) const
+        {
+            MPICXX_INSTRUMENT("iscatterv", implementation, receive_buffer.size(), predefined_datatype<VT>().get());
+            MPI_Request request_implementation;
+            handle_error(
+                MPI_Iscatterv(
+                    send_buffer.data(),
+                    send_counts.data(),
+                    displacements.data(),
+                    predefined_datatype<VT>().get(),
+                    receive_buffer.data(),
+                    details::checked_count(receive_buffer.size()),
+                    predefined_datatype<VT>().get(),
+                    root,
+                    implementation,
+                    &request_implementation));
+            return request(request_implementation);
+        }
+
+        template <typename VT>
+        request igather(VT &send_buffer, std::vector<VT> &receive_buffer, int root) const
+        {
+            MPICXX_INSTRUMENT("igather", implementation, 1, predefined_datatype<VT>().get());
+            MPI_Request request_implementation;
             handle_error(
                 MPI_Igather(
                     &send_buffer,
@@ -241,11 +1403,12 @@ namespace mpicxx
         template <typename VT>
         request igatherv(std::vector<VT> &send_buffer, std::vector<VT> &receive_buffer, std::vector<int> &recv_counts, std::vector<int> &recv_disp, int root) const
         {
+            MPICXX_INSTRUMENT("igatherv", implementation, send_buffer.size(), predefined_datatype<VT>().get());
             MPI_Request request_implementation;
             handle_error(
                 MPI_Igatherv(
                     send_buffer.data(),
-                    send_buffer.size(),
+                    details::checked_count(send_buffer.size()),
                     predefined_datatype<VT>().get(),
                     receive_buffer.data(),
                     recv_counts.data(),
@@ -257,9 +1420,152 @@ namespace mpicxx
             return request(request_implementation);
         }
 
+        // Container forms of the collectives above. Result vectors are
+        // resized before the operation starts; count and displacement
+        // vectors must stay alive until the request completes. ialltoall
+        // buffers must hold the same number of elements for every rank.
+        template <typename VT>
+        request ialltoall(std::vector<VT> const &send_buffer, std::vector<VT> &receive_buffer) const
+        {
+            std::size_t count = block_count(send_buffer.size(), size());
+            receive_buffer.resize(send_buffer.size());
+            return ialltoall_count(send_buffer.data(), receive_buffer.data(), count, predefined_datatype<VT>());
+        }
+
+        template <typename VT>
+        request ialltoall(std::vector<VT> &buffer) const
+        {
+            return ialltoall_count(MPI_IN_PLACE, buffer.data(), block_count(buffer.size(), size()), predefined_datatype<VT>());
+        }
+
+        template <typename VT>
+        request ialltoallv(std::vector<VT> const &send_buffer, std::vector<int> const &send_counts, std::vector<int> const &send_disp, std::vector<VT> &receive_buffer, std::vector<int> const &recv_counts, std::vector<int> const &recv_disp) const
+        {
+            return ialltoallv(send_buffer.data(), send_counts.data(), send_disp.data(), receive_buffer.data(), recv_counts.data(), recv_disp.data());
+        }
+
+        template <typename VT>
+        request iallgather(VT const &send_buffer, std::vector<VT> &receive_buffer) const
+        {
+            receive_buffer.resize(size());
+            return iallgather(&send_buffer, receive_buffer.data(), 1);
+        }
+
+        template <typename VT>
+        request iallgather(std::vector<VT> const &send_buffer, std::vector<VT> &receive_buffer) const
+        {
+            receive_buffer.resize(send_buffer.size() * size());
+            return iallgather_count(send_buffer.data(), receive_buffer.data(), send_buffer.size(), predefined_datatype<VT>());
+        }
+
+        template <typename VT>
+        request iallgatherv(std::vector<VT> const &send_buffer, std::vector<VT> &receive_buffer, std::vector<int> const &recv_counts, std::vector<int> const &recv_disp) const
+        {
+            return iallgatherv(send_buffer.data(), details::checked_count(send_buffer.size()), receive_buffer.data(), recv_counts.data(), recv_disp.data());
+        }
+
+        // Large-count v-collectives: counts and displacements are in elements
+        // and may exceed INT_MAX; the count vectors are copied, so only the
+        // buffers must outlive the request. Without MPI-4 the transfers run
+        // as point-to-point messages on a private duplicate of the
+        // communicator.
+        template <typename VT>
+        request igatherv(std::vector<VT> const &send_buffer, std::vector<VT> &receive_buffer, std::vector<std::size_t> const &recv_counts, std::vector<std::size_t> const &recv_displs, int root) const
+        {
+            return igatherv_count(send_buffer.data(), send_buffer.size(), receive_buffer.data(), recv_counts, recv_displs, predefined_datatype<VT>(), root);
+        }
+
+        template <typename VT>
+        request iscatterv(std::vector<VT> const &send_buffer, std::vector<std::size_t> const &send_counts, std::vector<std::size_t> const &send_displs, std::vector<VT> &receive_buffer, int root) const
+        {
+            return iscatterv_count(send_buffer.data(), send_counts, send_displs, receive_buffer.data(), receive_buffer.size(), predefined_datatype<VT>(), root);
+        }
+
+        template <typename VT>
+        request iallgatherv(std::vector<VT> const &send_buffer, std::vector<VT> &receive_buffer, std::vector<std::size_t> const &recv_counts, std::vector<std::size_t> const &recv_displs) const
+        {
+            return iallgatherv_count(send_buffer.data(), send_buffer.size(), receive_buffer.data(), recv_counts, recv_displs, predefined_datatype<VT>());
+        }
+
+        template <typename VT>
+        request ialltoallv(std::vector<VT> const &send_buffer, std::vector<std::size_t> const &send_counts, std::vector<std::size_t> const &send_displs, std::vector<VT> &receive_buffer, std::vector<std::size_t> const &recv_counts, std::vector<std::size_t> const &recv_displs) const
+        {
+            return ialltoallv_count(send_buffer.data(), send_counts, send_displs, receive_buffer.data(), recv_counts, recv_displs, predefined_datatype<VT>());
+        }
+
+        template <typename VT>
+        request ireduce(std::vector<VT> const &send_buffer, std::vector<VT> &receive_buffer, op const &op_arg, int root) const
+        {
+            if (rank() == root)
+            {
+                receive_buffer.resize(send_buffer.size());
+            }
+            return ireduce_count(send_buffer.data(), receive_buffer.data(), send_buffer.size(), predefined_datatype<VT>(), op_arg, root);
+        }
+
+        template <typename VT>
+        request ireduce(std::vector<VT> &buffer, op const &op_arg, int root) const
+        {
+            return ireduce(buffer.data(), buffer.size(), op_arg, root);
+        }
+
+        template <typename VT>
+        request ireduce_scatter(std::vector<VT> const &send_buffer, std::vector<VT> &receive_buffer, std::vector<int> const &recv_counts, op const &op_arg) const
+        {
+            receive_buffer.resize(recv_counts[rank()]);
+            return ireduce_scatter(send_buffer.data(), receive_buffer.data(), recv_counts.data(), op_arg);
+        }
+
+        template <typename VT>
+        request ireduce_scatter_block(std::vector<VT> const &send_buffer, std::vector<VT> &receive_buffer, op const &op_arg) const
+        {
+            int recv_count = details::checked_count(send_buffer.size() / size());
+            receive_buffer.resize(recv_count);
+            return ireduce_scatter_block(send_buffer.data(), receive_buffer.data(), recv_count, op_arg);
+        }
+
+        template <typename VT>
+        request iscan(VT const &send_buffer, VT &receive_buffer, op const &op_arg) const
+        {
+            return iscan(&send_buffer, &receive_buffer, 1, op_arg);
+        }
+
+        template <typename VT>
+        request iscan(std::vector<VT> const &send_buffer, std::vector<VT> &receive_buffer, op const &op_arg) const
+        {
+            receive_buffer.resize(send_buffer.size());
+            return iscan_count(send_buffer.data(), receive_buffer.data(), send_buffer.size(), predefined_datatype<VT>(), op_arg);
+        }
+
+        template <typename VT>
+        request iscan(std::vector<VT> &buffer, op const &op_arg) const
+        {
+            return iscan_count(MPI_IN_PLACE, buffer.data(), buffer.size(), predefined_datatype<VT>(), op_arg);
+        }
+
+        template <typename VT>
+        request iexscan(VT const &send_buffer, VT &receive_buffer, op const &op_arg) const
+        {
+            return iexscan(&send_buffer, &receive_buffer, 1, op_arg);
+        }
+
+        template <typename VT>
+        request iexscan(std::vector<VT> const &send_buffer, std::vector<VT> &receive_buffer, op const &op_arg) const
+        {
+            receive_buffer.resize(send_buffer.size());
+            return iexscan_count(send_buffer.data(), receive_buffer.data(), send_buffer.size(), predefined_datatype<VT>(), op_arg);
+        }
+
+        template <typename VT>
+        request iexscan(std::vector<VT> &buffer, op const &op_arg) const
+        {
+            return iexscan_count(MPI_IN_PLACE, buffer.data(), buffer.size(), predefined_datatype<VT>(), op_arg);
+        }
+
         template <typename VT>
         void exscan(const VT &sendbuf, std::vector<VT> &recvbuf, op const &op_arg) const
         {
+            MPICXX_INSTRUMENT("exscan", implementation, 1, predefined_datatype<VT>().get());
             handle_error(
                 MPI_Exscan(
                     &sendbuf,
@@ -270,10 +1576,119 @@ namespace mpicxx
                     implementation));
         }
 
+        template <typename VT>
+        request ineighbor_allgather(VT const &send_buffer, std::vector<VT> &receive_buffer) const
+        {
+            MPICXX_INSTRUMENT("ineighbor_allgather", implementation, 1, predefined_datatype<VT>().get());
+            MPI_Request request_implementation;
+            handle_error(
+                MPI_Ineighbor_allgather(
+                    &send_buffer,
+                    1,
+                    predefined_datatype<VT>().get(),
+                    receive_buffer.data(),
+                    1,
+                    predefined_datatype<VT>().get(),
+                    implementation,
+                    &request_implementation));
+            return request(request_implementation);
+        }
+
+        template <typename VT>
+        request ineighbor_allgather(std::vector<VT> const &send_buffer, std::vector<VT> &receive_buffer) const
+        {
+            MPICXX_INSTRUMENT("ineighbor_allgather", implementation, send_buffer.size(), predefined_datatype<VT>().get());
+            MPI_Request request_implementation;
+            handle_error(
+                MPI_Ineighbor_allgather(
+                    send_buffer.data(),
+                    details::checked_count(send_buffer.size()),
+                    predefined_datatype<VT>().get(),
+                    receive_buffer.data(),
+                    details::checked_count(send_buffer.size()),
+                    predefined_datatype<VT>().get(),
+                    implementation,
+                    &request_implementation));
+            return request(request_implementation);
+        }
+
+        template <typename VT>
+        request ineighbor_allgatherv(std::vector<VT> const &send_buffer, std::vector<VT> &receive_buffer, std::vector<int> const &recv_counts, std::vector<int> const &recv_disp) const
+        {
+            MPICXX_INSTRUMENT("ineighbor_allgatherv", implementation, send_buffer.size(), predefined_datatype<VT>().get());
+            MPI_Request request_implementation;
+            handle_error(
+                MPI_Ineighbor_allgatherv(
+                    send_buffer.data(),
+                    details::checked_count(send_buffer.size()),
+                    predefined_datatype<VT>().get(),
+                    receive_buffer.data(),
+                    recv_counts.data(),
+                    recv_disp.data(),
+                    predefined_datatype<VT>().get(),
+                    implementation,
+                    &request_implementation));
+            return request(request_implementation);
+        }
+
+        // count elements go to and come from each neighbor, in the order
+        // given by dist_graph_neighbors (or the Cartesian shift order).
+        template <typename VT>
+        request ineighbor_alltoall(std::vector<VT> const &send_buffer, std::vector<VT> &receive_buffer, int count) const
+        {
+            MPICXX_INSTRUMENT("ineighbor_alltoall", implementation, send_buffer.size(), predefined_datatype<VT>().get());
+            MPI_Request request_implementation;
+            handle_error(
+                MPI_Ineighbor_alltoall(
+                    send_buffer.data(),
+                    count,
+                    predefined_datatype<VT>().get(),
+                    receive_buffer.data(),
+                    count,
+                    predefined_datatype<VT>().get(),
+                    implementation,
+                    &request_implementation));
+            return request(request_implementation);
+        }
+
+        template <typename VT>
+        request ineighbor_alltoallv(std::vector<VT> const &send_buffer, std::vector<int> const &send_counts, std::vector<int> const &send_disp, std::vector<VT> &receive_buffer, std::vector<int> const &recv_counts, std::vector<int> const &recv_disp) const
+        {
+            MPICXX_INSTRUMENT("ineighbor_alltoallv", implementation, send_buffer.size(), predefined_datatype<VT>().get());
+            MPI_Request request_implementation;
+            handle_error(
+                MPI_Ineighbor_alltoallv(
+                    send_buffer.data(),
+                    send_counts.data(),
+                    send_disp.data(),
+                    predefined_datatype<VT>().get(),
+                    receive_buffer.data(),
+                    recv_counts.data(),
+                    recv_disp.data(),
+                    predefined_datatype<VT>().get(),
+                    implementation,
+                    &request_implementation));
+            return request(request_implementation);
+        }
+
+        request ineighbor_alltoallw(
+            void const *sendbuf,
+            std::vector<int> const &send_counts,
+            std::vector<MPI_Aint> const &send_disp,
+            std::vector<MPI_Datatype> const &send_types,
+            void *recvbuf,
+            std::vector<int> const &recv_counts,
+            std::vector<MPI_Aint> const &recv_disp,
+            std::vector<MPI_Datatype> const &recv_types) const;
+
         static comm world();
         static comm self();
         comm dup() const;
         request ibarrier() const;
+        // Blocks until every detached request has completed. Detached
+        // requests are tracked per process rather than per communicator, so
+        // this also completes those detached on other communicators.
+        void quiesce() const;
         comm split(int color, int key) const;
         comm split_type(int split_type, int key, MPI_Info info = MPI_INFO_NULL) const;
         comm cart_create(
@@ -289,6 +1704,30 @@ namespace mpicxx
             int coords[]) const;
         int cart_rank(int const coords[]) const;
         void cart_coords(int rank, int maxdims, int coords[]) const;
+        // Weighted graph: one weight per neighbor. A rank without sources or
+        // destinations passes empty vectors (MPI_WEIGHTS_EMPTY).
+        comm dist_graph_create_adjacent(
+            std::vector<int> const &sources,
+            std::vector<int> const &sourceweights,
+            std::vector<int> const &destinations,
+            std::vector<int> const &destweights,
+            int reorder,
+            MPI_Info info = MPI_INFO_NULL) const;
+        // Unweighted graph (MPI_UNWEIGHTED); every rank must use this overload.
+        comm dist_graph_create_adjacent(
+            std::vector<int> const &sources,
+            std::vector<int> const &destinations,
+            int reorder,
+            MPI_Info info = MPI_INFO_NULL) const;
+        void dist_graph_neighbors_count(int &indegree, int &outdegree) const;
+        void dist_graph_neighbors(
+            std::vector<int> &sources,
+            std::vector<int> &destinations) const;
+        void dist_graph_neighbors(
+            std::vector<int> &sources,
+            std::vector<int> &sourceweights,
+            std::vector<int> &destinations,
+            std::vector<int> &destweights) const;
         constexpr MPI_Comm get() const { return implementation; }
     };
 }
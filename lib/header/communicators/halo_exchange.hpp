@@ -0,0 +1,56 @@
+#ifndef MPICPP_HEADER_COMMUNICATOR_HALO_EXCHANGE_HPP
+#define MPICPP_HEADER_COMMUNICATOR_HALO_EXCHANGE_HPP
+#pragma once
+
+#include <mpi.h>
+#include <vector>
+
+#include "communicators/comm.hpp"
+#include "datatype/datatype.hpp"
+#include "handles/request.hpp"
+
+namespace mpicxx
+{
+    // Ghost-cell exchange for a row-major array distributed over a Cartesian
+    // communicator. The local array has local_extents[d] + 2 * ghost_width
+    // elements in dimension d. Subarray datatypes and persistent requests for
+    // every face (and, with include_corners, every edge and corner) are built
+    // once, so each step is a single startall and waitall. The requests live
+    // on a private duplicate of cart, so their direction tags cannot match
+    // the caller's own messages; constructing one is collective over cart.
+    class halo_exchange
+    {
+        comm neighbors;
+        std::vector<datatype> types;
+        std::vector<persistent_request> requests;
+
+    public:
+        halo_exchange(
+            comm const &cart,
+            std::vector<int> const &local_extents,
+            int ghost_width,
+            void *data,
+            datatype const &element_type,
+            bool include_corners = true);
+        template <class T>
+        halo_exchange(
+            comm const &cart,
+            std::vector<int> const &local_extents,
+            int ghost_width,
+            T *data,
+            bool include_corners = true)
+            : halo_exchange(cart, local_extents, ghost_width, data, predefined_datatype<T>(), include_corners)
+        {
+        }
+        void start();
+        void finish();
+        void exchange()
+        {
+            start();
+            finish();
+        }
+        int neighbor_count() const { return int(requests.size() / 2); }
+    };
+}
+
+#endif
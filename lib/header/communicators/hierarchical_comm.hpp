@@ -0,0 +1,91 @@
+#ifndef MPICPP_HEADER_COMMUNICATOR_HIERARCHICAL_COMM_HPP
+#define MPICPP_HEADER_COMMUNICATOR_HIERARCHICAL_COMM_HPP
+#pragma once
+
+#include <mpi.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "communicators/comm.hpp"
+#include "datatype/datatype.hpp"
+#include "onesided/shared_array.hpp"
+#include "reductionoperation/reductionop.hpp"
+
+namespace mpicxx
+{
+    // Node-aware collectives. Ranks of a node first combine through a shared
+    // memory window, one leader per node then talks over the network, and
+    // the result is read back from shared memory. Collectives are blocking
+    // and, like their flat counterparts, must be called by every rank of
+    // the parent communicator. Reductions with non-commutative operations
+    // are only ordered correctly when nodes hold contiguous parent ranks.
+    class hierarchical_comm
+    {
+        comm node;
+        comm leaders;
+        int parent_rank;
+        int parent_size;
+        // Parent rank p lives on node node_of_rank[p] as node rank
+        // node_rank_of_rank[p]; slot_of_rank[p] is its node-major position.
+        std::vector<int> node_of_rank;
+        std::vector<int> node_rank_of_rank;
+        std::vector<int> slot_of_rank;
+        std::vector<int> node_sizes;
+        std::unique_ptr<shared_array<char>> contributions;
+        std::unique_ptr<shared_array<char>> results;
+
+        void build(comm const &parent);
+        void reserve(std::size_t contribution_bytes, std::size_t result_bytes);
+        void node_barrier() const;
+        char *pack_node_block(
+            int count,
+            std::size_t bytes,
+            std::vector<int> &counts,
+            std::vector<int> &displacements);
+        void unpack_rank_order(void *recvbuf, std::size_t bytes) const;
+
+    public:
+        explicit hierarchical_comm(comm const &parent);
+        // Splits every shared-memory node further into pseudo-nodes of at most
+        // ranks_per_node ranks, to exercise the inter-node path on one machine.
+        hierarchical_comm(comm const &parent, int ranks_per_node);
+        hierarchical_comm(hierarchical_comm const &) = delete;
+        hierarchical_comm &operator=(hierarchical_comm const &) = delete;
+        hierarchical_comm(hierarchical_comm &&) = default;
+        hierarchical_comm &operator=(hierarchical_comm &&) = default;
+
+        comm const &node_comm() const { return node; }
+        comm const &leader_comm() const { return leaders; }
+        bool is_leader() const { return leaders.get() != MPI_COMM_NULL; }
+        int node_count() const { return int(node_sizes.size()); }
+
+        void allreduce(void *buf, int count, datatype const &datatype_arg, op const &op_arg);
+        void bcast(void *buf, int count, datatype const &datatype_arg, int root);
+        void gather(void const *sendbuf, int count, datatype const &datatype_arg, void *recvbuf, int root);
+        void allgather(void const *sendbuf, int count, datatype const &datatype_arg, void *recvbuf);
+
+        template <class T>
+        void allreduce(T *buf, int count, op const &op_arg)
+        {
+            allreduce(buf, count, predefined_datatype<T>(), op_arg);
+        }
+        template <class T>
+        void bcast(T *buf, int count, int root)
+        {
+            bcast(buf, count, predefined_datatype<T>(), root);
+        }
+        template <class T>
+        void gather(T const *sendbuf, int count, T *recvbuf, int root)
+        {
+            gather(sendbuf, count, predefined_datatype<T>(), recvbuf, root);
+        }
+        template <class T>
+        void allgather(T const *sendbuf, int count, T *recvbuf)
+        {
+            allgather(sendbuf, count, predefined_datatype<T>(), recvbuf);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,250 @@
+#ifndef MPICPP_HEADER_CONTAINERS_DIST_VECTOR_HPP
+#define MPICPP_HEADER_CONTAINERS_DIST_VECTOR_HPP
+#pragma once
+
+#include <mpi.h>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "communicators/comm.hpp"
+#include "datatype/datatype.hpp"
+#include "error/exception.hpp"
+
+namespace mpicxx
+{
+    // Maps the global indices of a distributed array to (owner, local index)
+    // pairs. block gives each rank one contiguous range, balanced so sizes
+    // differ by at most one; block_cyclic deals fixed-size blocks to the
+    // ranks round-robin. In both, a rank's local elements are stored in
+    // increasing global order.
+    class dist_layout
+    {
+        std::size_t global_size;
+        int rank_count;
+        // Zero for block layouts.
+        std::size_t cycle_block;
+
+        dist_layout(std::size_t global_size_arg, int rank_count_arg, std::size_t cycle_block_arg);
+
+    public:
+        static dist_layout block(std::size_t global_size_arg, int rank_count_arg);
+        static dist_layout block_cyclic(std::size_t global_size_arg, int rank_count_arg, std::size_t block_size_arg);
+        std::size_t size() const { return global_size; }
+        int ranks() const { return rank_count; }
+        bool is_block_cyclic() const { return cycle_block != 0; }
+        std::size_t block_size() const { return cycle_block; }
+        int owner(std::size_t global_index) const;
+        std::size_t local_index(std::size_t global_index) const;
+        std::size_t global_index(int rank, std::size_t local_index_arg) const;
+        std::size_t local_size(int rank) const;
+        // Number of contiguous global ranges held by rank, and the k-th one
+        // as (first global index, length).
+        std::size_t local_blocks(int rank) const;
+        std::pair<std::size_t, std::size_t> local_block(int rank, std::size_t k) const;
+        bool operator==(dist_layout const &other) const
+        {
+            return global_size == other.global_size && rank_count == other.rank_count && cycle_block == other.cycle_block;
+        }
+        bool operator!=(dist_layout const &other) const { return !(*this == other); }
+    };
+
+    template <class T>
+    class local_span
+    {
+        T *first;
+        std::size_t count;
+
+    public:
+        constexpr local_span(T *first_arg, std::size_t count_arg)
+            : first(first_arg), count(count_arg)
+        {
+        }
+        constexpr T *data() const { return first; }
+        constexpr std::size_t size() const { return count; }
+        constexpr bool empty() const { return count == 0; }
+        constexpr T *begin() const { return first; }
+        constexpr T *end() const { return first + count; }
+        constexpr T &operator[](std::size_t i) const { return first[i]; }
+    };
+
+    namespace details
+    {
+        // Routing of a batched get/put: the caller's indices grouped by
+        // owner (order[k] is the caller position of the k-th packed entry),
+        // and the owner-local indices this rank was asked for, grouped by
+        // requesting rank. Counts and displacements are in elements.
+        struct owner_plan
+        {
+            std::vector<int> send_counts;
+            std::vector<int> send_displs;
+            std::vector<int> recv_counts;
+            std::vector<int> recv_displs;
+            std::vector<std::size_t> order;
+            std::vector<std::uint64_t> requested;
+        };
+
+        owner_plan plan_by_owner(comm const &comm_arg, dist_layout const &layout_arg, std::vector<std::size_t> const &indices);
+
+        // Counts and displacements of the single alltoallv that moves every
+        // local element from one layout to another.
+        struct redistribution_plan
+        {
+            std::vector<int> send_counts;
+            std::vector<int> send_displs;
+            std::vector<int> recv_counts;
+            std::vector<int> recv_displs;
+            // Destination rank of each old local element, and source rank of
+            // each new local element, both in local (= global) order.
+            std::vector<int> destinations;
+            std::vector<int> sources;
+        };
+
+        redistribution_plan plan_redistribution(dist_layout const &from, dist_layout const &to, int rank);
+    }
+
+    // An array of size() elements spread over the ranks of a communicator
+    // according to a dist_layout. Local elements are stored contiguously and
+    // can be used directly through local(); remote ones are read and written
+    // in batches with get() and put(), which, like redistribute(), are
+    // collective: every rank calls them, with an empty index list if it has
+    // nothing to transfer. T must have an MPI datatype (see
+    // predefined_datatype). The communicator must outlive the vector.
+    template <class T>
+    class dist_vector
+    {
+        comm world;
+        dist_layout layout_implementation;
+        std::vector<T> elements;
+
+    public:
+        dist_vector(comm const &comm_arg, dist_layout layout_arg, T const &value = T())
+            : world(comm_arg.get(), false), layout_implementation(std::move(layout_arg))
+        {
+            if (layout_implementation.ranks() != world.size())
+            {
+                throw exception("mpicxx::dist_vector layout does not match the communicator size");
+            }
+            elements.assign(layout_implementation.local_size(world.rank()), value);
+        }
+        dist_vector(comm const &comm_arg, std::size_t global_size, T const &value = T())
+            : dist_vector(comm_arg, dist_layout::block(global_size, comm_arg.size()), value)
+        {
+        }
+        dist_vector(dist_vector const &) = delete;
+        dist_vector &operator=(dist_vector const &) = delete;
+        dist_vector(dist_vector &&) = default;
+        dist_vector &operator=(dist_vector &&) = default;
+
+        comm const &get_comm() const { return world; }
+        dist_layout const &layout() const { return layout_implementation; }
+        std::size_t size() const { return layout_implementation.size(); }
+        std::size_t local_size() const { return elements.size(); }
+        local_span<T> local() { return local_span<T>(elements.data(), elements.size()); }
+        local_span<T const> local() const { return local_span<T const>(elements.data(), elements.size()); }
+        // The k-th contiguous global range held locally; its first element
+        // has global index layout().local_block(rank, k).first.
+        std::size_t local_blocks() const { return layout_implementation.local_blocks(world.rank()); }
+        local_span<T> local_block(std::size_t k)
+        {
+            std::pair<std::size_t, std::size_t> range = layout_implementation.local_block(world.rank(), k);
+            return local_span<T>(elements.data() + layout_implementation.local_index(range.first), range.second);
+        }
+        bool is_local(std::size_t global_index) const
+        {
+            return layout_implementation.owner(global_index) == world.rank();
+        }
+        // The local element with the given global index.
+        T &local_at(std::size_t global_index)
+        {
+            return elements[layout_implementation.local_index(global_index)];
+        }
+
+        // Reads the elements at indices, wherever they live, into a vector
+        // in the same order. Requests are batched per owner.
+        std::vector<T> get(std::vector<std::size_t> const &indices) const
+        {
+            details::owner_plan plan = details::plan_by_owner(world, layout_implementation, indices);
+            std::vector<T> replies(plan.requested.size());
+            for (std::size_t i = 0; i < replies.size(); ++i)
+            {
+                replies[i] = elements[plan.requested[i]];
+            }
+            std::vector<T> packed(indices.size());
+            world.ialltoallv(
+                     replies.data(), plan.recv_counts.data(), plan.recv_displs.data(),
+                     packed.data(), plan.send_counts.data(), plan.send_displs.data())
+                .wait();
+            std::vector<T> result(indices.size());
+            for (std::size_t k = 0; k < packed.size(); ++k)
+            {
+                result[plan.order[k]] = std::move(packed[k]);
+            }
+            return result;
+        }
+
+        // Writes values[i] to global index indices[i]. If several ranks write
+        // the same index, which value is kept is unspecified.
+        void put(std::vector<std::size_t> const &indices, std::vector<T> const &values)
+        {
+            if (indices.size() != values.size())
+            {
+                throw exception("mpicxx::dist_vector::put needs one value per index");
+            }
+            details::owner_plan plan = details::plan_by_owner(world, layout_implementation, indices);
+            std::vector<T> packed(values.size());
+            for (std::size_t k = 0; k < packed.size(); ++k)
+            {
+                packed[k] = values[plan.order[k]];
+            }
+            std::vector<T> received(plan.requested.size());
+            world.ialltoallv(
+                     packed.data(), plan.send_counts.data(), plan.send_displs.data(),
+                     received.data(), plan.recv_counts.data(), plan.recv_displs.data())
+                .wait();
+            for (std::size_t i = 0; i < received.size(); ++i)
+            {
+                elements[plan.requested[i]] = std::move(received[i]);
+            }
+        }
+
+        // Moves every element to its owner under new_layout with a single
+        // alltoallv. Both sides of each exchange derive the counts from the
+        // two layouts, so no sizes are communicated.
+        void redistribute(dist_layout const &new_layout)
+        {
+            if (new_layout.size() != size() || new_layout.ranks() != world.size())
+            {
+                throw exception("mpicxx::dist_vector::redistribute needs a layout of the same size and rank count");
+            }
+            if (new_layout == layout_implementation)
+            {
+                return;
+            }
+            details::redistribution_plan plan = details::plan_redistribution(layout_implementation, new_layout, world.rank());
+            // Elements bound for each rank are packed in increasing global
+            // order, which is also the order the receiver stores them in.
+            std::vector<int> cursor(plan.send_displs);
+            std::vector<T> packed(elements.size());
+            for (std::size_t i = 0; i < elements.size(); ++i)
+            {
+                packed[cursor[plan.destinations[i]]++] = std::move(elements[i]);
+            }
+            std::vector<T> received(plan.sources.size());
+            world.ialltoallv(
+                     packed.data(), plan.send_counts.data(), plan.send_displs.data(),
+                     received.data(), plan.recv_counts.data(), plan.recv_displs.data())
+                .wait();
+            cursor = plan.recv_displs;
+            elements.resize(received.size());
+            for (std::size_t i = 0; i < received.size(); ++i)
+            {
+                elements[i] = std::move(received[cursor[plan.sources[i]]++]);
+            }
+            layout_implementation = new_layout;
+        }
+    };
+}
+
+#endif
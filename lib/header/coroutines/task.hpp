@@ -0,0 +1,223 @@
+#ifndef MPICPP_HEADER_COROUTINES_TASK_HPP
+#define MPICPP_HEADER_COROUTINES_TASK_HPP
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define MPICXX_HAS_COROUTINES 1
+#endif
+
+#ifdef MPICXX_HAS_COROUTINES
+
+#include <mpi.h>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "error/exception.hpp"
+#include "handles/completion_queue.hpp"
+#include "handles/request.hpp"
+#include "handles/status.hpp"
+
+namespace mpicxx
+{
+    // Suspends the awaiting coroutine until the request completes. The
+    // request is parked in the thread's completion_queue, so resumption
+    // happens from mpicxx::progress() or scheduler::run() on this thread.
+    // The queued callback shares the resumption state with the awaiter
+    // instead of pointing into the coroutine frame; if the frame is
+    // destroyed first, the callback finds no coroutine to resume.
+    class request_awaiter
+    {
+        struct resumption
+        {
+            status result;
+            std::coroutine_handle<> awaiting;
+        };
+
+        request pending;
+        std::shared_ptr<resumption> state;
+
+    public:
+        explicit request_awaiter(request &&request_arg)
+            : pending(std::move(request_arg)), state(std::make_shared<resumption>())
+        {
+        }
+        request_awaiter(request_awaiter const &) = delete;
+        request_awaiter &operator=(request_awaiter const &) = delete;
+        ~request_awaiter()
+        {
+            state->awaiting = nullptr;
+        }
+        bool await_ready()
+        {
+            return pending.test(state->result);
+        }
+        void await_suspend(std::coroutine_handle<> awaiting)
+        {
+            state->awaiting = awaiting;
+            pending.then(
+                [shared = state](status const &status_arg)
+                {
+                    shared->result = status_arg;
+                    if (shared->awaiting)
+                    {
+                        shared->awaiting.resume();
+                    }
+                });
+        }
+        status await_resume() const { return state->result; }
+    };
+
+    inline request_awaiter operator co_await(request &&request_arg)
+    {
+        return request_awaiter(std::move(request_arg));
+    }
+
+    // An eagerly started coroutine. A task may itself be co_awaited from
+    // another task, in which case the parent resumes when it finishes.
+    class task
+    {
+    public:
+        struct promise_type
+        {
+            std::coroutine_handle<> continuation;
+            std::exception_ptr error;
+
+            task get_return_object()
+            {
+                return task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            auto final_suspend() noexcept
+            {
+                struct final_awaiter
+                {
+                    bool await_ready() noexcept { return false; }
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> finished) noexcept
+                    {
+                        std::coroutine_handle<> next = finished.promise().continuation;
+                        return next ? next : std::noop_coroutine();
+                    }
+                    void await_resume() noexcept {}
+                };
+                return final_awaiter{};
+            }
+            void return_void() {}
+            void unhandled_exception() { error = std::current_exception(); }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+
+        explicit task(std::coroutine_handle<promise_type> handle_arg)
+            : handle(handle_arg)
+        {
+        }
+
+        // Like ~request, runs the thread's completion_queue until the task
+        // has finished, so no request it is suspended on is left writing
+        // into a destroyed frame. A parent that awaited it is not resumed.
+        void release()
+        {
+            if (!handle)
+            {
+                return;
+            }
+            handle.promise().continuation = nullptr;
+            completion_queue &queue = completion_queue::local();
+            while (!handle.done() && !queue.empty())
+            {
+                queue.wait();
+            }
+            handle.destroy();
+            handle = nullptr;
+        }
+
+    public:
+        task(task const &) = delete;
+        task &operator=(task const &) = delete;
+        task(task &&other) noexcept
+            : handle(std::exchange(other.handle, nullptr))
+        {
+        }
+        task &operator=(task &&other)
+        {
+            release();
+            handle = std::exchange(other.handle, nullptr);
+            return *this;
+        }
+        ~task()
+        {
+            release();
+        }
+        bool done() const { return !handle || handle.done(); }
+        std::exception_ptr error() const
+        {
+            return handle ? handle.promise().error : nullptr;
+        }
+        void rethrow_if_failed() const
+        {
+            if (std::exception_ptr failure = error())
+            {
+                std::rethrow_exception(failure);
+            }
+        }
+        bool await_ready() const { return done(); }
+        void await_suspend(std::coroutine_handle<> awaiting)
+        {
+            handle.promise().continuation = awaiting;
+        }
+        void await_resume() const { rethrow_if_failed(); }
+    };
+
+    // Runs spawned tasks on the calling thread, blocking in MPI_Waitsome on
+    // the thread's completion_queue until every task has finished; a task
+    // that nothing in the queue can resume any more makes run() throw. An
+    // exception escaping a task is rethrown only after the other tasks have
+    // finished. Tasks that start collectives on a shared communicator must
+    // still start them in the same order on every rank.
+    class scheduler
+    {
+        std::vector<task> tasks;
+
+    public:
+        void spawn(task &&task_arg)
+        {
+            tasks.push_back(std::move(task_arg));
+        }
+        void run()
+        {
+            completion_queue &queue = completion_queue::local();
+            bool stuck = false;
+            std::exception_ptr error;
+            for (task &pending : tasks)
+            {
+                while (!pending.done() && !queue.empty())
+                {
+                    queue.wait();
+                }
+                // Nothing left in the queue can resume it.
+                stuck = stuck || !pending.done();
+                if (!error)
+                {
+                    error = pending.error();
+                }
+            }
+            tasks.clear();
+            if (stuck)
+            {
+                throw exception("mpicxx::scheduler::run: a task is suspended on something other than an MPI request");
+            }
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    };
+}
+
+#endif
+
+#endif
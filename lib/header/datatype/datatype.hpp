@@ -3,8 +3,11 @@
 #pragma once
 
 #include <mpi.h>
+#include <array>
 #include <cstddef>
 
+#include "error/exception.hpp"
+
 namespace mpicxx
 {
 
@@ -35,15 +38,42 @@ namespace mpicxx
         datatype &operator=(datatype &&other);
         ~datatype();
         constexpr MPI_Datatype get() const { return implementation; }
+        void commit();
+        MPI_Datatype release();
+        static datatype create_contiguous(
+            int count,
+            datatype const &oldtype);
+        static datatype create_struct(
+            int count,
+            int const blocklengths[],
+            MPI_Aint const displacements[],
+            MPI_Datatype const types[]);
+        static datatype create_resized(
+            datatype const &oldtype,
+            MPI_Aint lb,
+            MPI_Aint extent);
+        static datatype create_subarray(
+            int ndims,
+            int const sizes[],
+            int const subsizes[],
+            int const starts[],
+            int order,
+            datatype const &oldtype);
         static datatype predefined_byte();
         static datatype predefined_char();
+        static datatype predefined_signed_char();
+        static datatype predefined_unsigned_char();
+        static datatype predefined_short();
+        static datatype predefined_unsigned_short();
         static datatype predefined_unsigned();
         static datatype predefined_unsigned_long();
         static datatype predefined_unsigned_long_long();
         static datatype predefined_int();
+        static datatype predefined_long();
         static datatype predefined_long_long_int();
         static datatype predefined_float();
         static datatype predefined_double();
+        static datatype predefined_long_double();
         static datatype predefined_bool();
         static datatype predefined_packed();
     };
@@ -74,6 +104,46 @@ namespace mpicxx
             }
         };
 
+        template <>
+        class predefined_datatype_helper<signed char>
+        {
+        public:
+            static datatype value()
+            {
+                return datatype::predefined_signed_char();
+            }
+        };
+
+        template <>
+        class predefined_datatype_helper<unsigned char>
+        {
+        public:
+            static datatype value()
+            {
+                return datatype::predefined_unsigned_char();
+            }
+        };
+
+        template <>
+        class predefined_datatype_helper<short>
+        {
+        public:
+            static datatype value()
+            {
+                return datatype::predefined_short();
+            }
+        };
+
+        template <>
+        class predefined_datatype_helper<unsigned short>
+        {
+        public:
+            static datatype value()
+            {
+                return datatype::predefined_unsigned_short();
+            }
+        };
+
         template <>
         class predefined_datatype_helper<unsigned>
         {
@@ -114,6 +184,16 @@ namespace mpicxx
             }
         };
 
+        template <>
+        class predefined_datatype_helper<long>
+        {
+        public:
+            static datatype value()
+            {
+                return datatype::predefined_long();
+            }
+        };
+
         template <>
         class predefined_datatype_helper<long long int>
         {
@@ -144,6 +224,16 @@ namespace mpicxx
             }
         };
 
+        template <>
+        class predefined_datatype_helper<long double>
+        {
+        public:
+            static datatype value()
+            {
+                return datatype::predefined_long_double();
+            }
+        };
+
         template <>
         class predefined_datatype_helper<bool>
         {
@@ -162,6 +252,95 @@ namespace mpicxx
         return details::predefined_datatype_helper<T>::value();
     }
 
+    namespace details
+    {
+        // Datatypes built on first use and kept for the lifetime of the
+        // process. They are freed by environment::finalize.
+        void register_cached_datatype(MPI_Datatype implementation);
+        void free_cached_datatypes();
+
+        // One element of the returned committed type covers count elements of
+        // oldtype, for counts that do not fit in an int.
+        datatype large_count_datatype(std::size_t count, datatype const &oldtype);
+
+        template <class M>
+        struct member_layout
+        {
+            using element_type = M;
+            static constexpr int count = 1;
+        };
+
+        template <class M, std::size_t N>
+        struct member_layout<M[N]>
+        {
+            using element_type = typename member_layout<M>::element_type;
+            static constexpr int count = int(N) * member_layout<M>::count;
+        };
+
+        template <class M, std::size_t N>
+        struct member_layout<std::array<M, N>>
+        {
+            using element_type = typename member_layout<M>::element_type;
+            static constexpr int count = int(N) * member_layout<M>::count;
+        };
+
+        template <class T, class M>
+        MPI_Aint member_displacement(T const &sample, MPI_Aint base, M T::*member)
+        {
+            MPI_Aint address;
+            handle_error(
+                MPI_Get_address(
+                    &(sample.*member),
+                    &address));
+            return MPI_Aint_diff(address, base);
+        }
+
+        template <class T, class... M>
+        MPI_Datatype create_struct_datatype(M T::*...members)
+        {
+            constexpr int count = sizeof...(M);
+            T const sample{};
+            MPI_Aint base;
+            handle_error(
+                MPI_Get_address(
+                    &sample,
+                    &base));
+            int const blocklengths[count] = {member_layout<M>::count...};
+            MPI_Aint const displacements[count] = {member_displacement(sample, base, members)...};
+            datatype const member_types[count] = {predefined_datatype<typename member_layout<M>::element_type>()...};
+            MPI_Datatype type_implementations[count];
+            for (int i = 0; i < count; ++i)
+            {
+                type_implementations[i] = member_types[i].get();
+            }
+            datatype layout = datatype::create_struct(count, blocklengths, displacements, type_implementations);
+            datatype resized = datatype::create_resized(layout, 0, sizeof(T));
+            resized.commit();
+            MPI_Datatype result = resized.release();
+            register_cached_datatype(result);
+            return result;
+        }
+    }
+
 } // namespace mpicxx
 
+// Makes predefined_datatype<type>() return a committed struct datatype built
+// from the listed member pointers, e.g.
+//   MPICXX_REGISTER_STRUCT(particle, &particle::position, &particle::id)
+// Members may be fundamental types, other registered structs, or fixed-size
+// arrays of those. The type is built once, on first use, and must be default
+// constructible. Use at global namespace scope.
+#define MPICXX_REGISTER_STRUCT(type, ...)                                        \
+    template <>                                                                  \
+    class mpicxx::details::predefined_datatype_helper<type>                      \
+    {                                                                            \
+    public:                                                                      \
+        static mpicxx::datatype value()                                          \
+        {                                                                        \
+            static MPI_Datatype const implementation =                           \
+                mpicxx::details::create_struct_datatype<type>(__VA_ARGS__);      \
+            return mpicxx::datatype(implementation, false);                      \
+        }                                                                        \
+    };
+
 #endif
@@ -0,0 +1,60 @@
+#ifndef MPICPP_HEADER_HANDLES_COMPLETION_QUEUE_HPP
+#define MPICPP_HEADER_HANDLES_COMPLETION_QUEUE_HPP
+#pragma once
+
+#include <mpi.h>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "request.hpp"
+#include "request_set.hpp"
+#include "status.hpp"
+
+namespace mpicxx
+{
+    // Pending requests paired with callbacks. poll() harvests completions with
+    // a single MPI_Testsome and runs the matching callbacks on the calling
+    // thread; callbacks may push further requests to continue a chain.
+    class completion_queue
+    {
+        request_set requests;
+        std::vector<std::function<void(status const &)>> callbacks;
+        std::vector<int> indices;
+        std::vector<status> statuses;
+
+        std::size_t complete(bool blocking);
+
+    public:
+        completion_queue() = default;
+        completion_queue(completion_queue const &) = delete;
+        completion_queue &operator=(completion_queue const &) = delete;
+        void push(request &&request_arg, std::function<void(status const &)> callback);
+        std::size_t poll();
+        std::size_t wait();
+        void drain();
+        std::size_t size() const { return callbacks.size(); }
+        bool empty() const { return callbacks.empty(); }
+        static completion_queue &local();
+    };
+
+    // Polls the calling thread's completion queue and returns the number of
+    // callbacks that ran.
+    std::size_t progress();
+
+    namespace details
+    {
+        // Process-wide tracker for requests given up with request::detach().
+        // reap_detached() harvests finished ones without blocking and is
+        // called from request::wait/test, progress() and every detach;
+        // drain_detached() blocks until all of them, including any that
+        // their callbacks detach in turn, have completed; any_detached()
+        // reports whether some are still outstanding.
+        void detach(request &&request_arg, std::function<void(status const &)> callback);
+        void reap_detached();
+        void drain_detached();
+        bool any_detached();
+    }
+}
+
+#endif
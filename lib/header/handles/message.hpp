@@ -0,0 +1,40 @@
+#ifndef MPICPP_HEADER_HANDLES_MESSAGE_HPP
+#define MPICPP_HEADER_HANDLES_MESSAGE_HPP
+
+#include <mpi.h>
+
+namespace mpicxx
+{
+    // A message removed from the matching queue by mprobe/improbe. It can
+    // only be received with imrecv, so no other receive (or thread) can
+    // steal it between probing and receiving.
+    class message
+    {
+        MPI_Message implementation;
+
+    public:
+        message()
+            : implementation(MPI_MESSAGE_NULL)
+        {
+        }
+        explicit constexpr message(MPI_Message implementation_arg)
+            : implementation(implementation_arg)
+        {
+        }
+        message(message const &) = delete;
+        message &operator=(message const &) = delete;
+        constexpr message(message &&other) noexcept
+            : implementation(other.implementation)
+        {
+            other.implementation = MPI_MESSAGE_NULL;
+        }
+        message &operator=(message &&other) noexcept
+        {
+            implementation = other.implementation;
+            other.implementation = MPI_MESSAGE_NULL;
+            return *this;
+        }
+        MPI_Message &get() { return implementation; }
+    };
+}
+#endif
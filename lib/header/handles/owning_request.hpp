@@ -0,0 +1,96 @@
+#ifndef MPICPP_HEADER_HANDLES_OWNING_REQUEST_HPP
+#define MPICPP_HEADER_HANDLES_OWNING_REQUEST_HPP
+#pragma once
+
+#include <mpi.h>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "error/exception.hpp"
+#include "request.hpp"
+#include "status.hpp"
+
+namespace mpicxx
+{
+    namespace details
+    {
+        // Keeps a send buffer alive until the request completes, then frees
+        // it with the continuation.
+        template <class Container>
+        class buffer_continuation : public request_continuation
+        {
+        public:
+            Container buffer;
+
+            explicit buffer_continuation(Container &&buffer_arg)
+                : buffer(std::move(buffer_arg))
+            {
+            }
+            bool complete(MPI_Request &) override
+            {
+                return true;
+            }
+        };
+    }
+
+    // A request that owns the buffer its operation writes into. The buffer
+    // lives on the heap so it stays put while the request is moved around,
+    // and take() hands it back once the operation has completed. Like
+    // request, destroying or assigning over a pending one waits for it.
+    template <class Container>
+    class owning_request
+    {
+        std::unique_ptr<Container> buffer;
+        // Declared after the buffer so it is destroyed, and waited on, first.
+        request operation;
+
+    public:
+        owning_request() = default;
+        owning_request(std::unique_ptr<Container> buffer_arg, request &&operation_arg)
+            : buffer(std::move(buffer_arg)), operation(std::move(operation_arg))
+        {
+        }
+        owning_request(owning_request &&other) noexcept = default;
+        owning_request &operator=(owning_request &&other)
+        {
+            // The pending operation must finish before its buffer is freed.
+            operation = std::move(other.operation);
+            buffer = std::move(other.buffer);
+            return *this;
+        }
+        void wait() { operation.wait(); }
+        bool test() { return operation.test(); }
+        void wait(status &status_arg) { operation.wait(status_arg); }
+        bool test(status &status_arg) { return operation.test(status_arg); }
+        // Waits for the operation and moves the received buffer out.
+        Container take()
+        {
+            operation.wait();
+            if (!buffer)
+            {
+                throw exception("mpicxx::owning_request has no buffer to take");
+            }
+            Container result = std::move(*buffer);
+            buffer.reset();
+            return result;
+        }
+        // Detaches the operation (see request::detach) together with its
+        // buffer, which is passed to the callback once it has completed.
+        void detach()
+        {
+            std::shared_ptr<Container> owned(std::move(buffer));
+            operation.detach([owned](status const &) {});
+        }
+        void detach(std::function<void(Container &, status const &)> callback)
+        {
+            std::shared_ptr<Container> owned(std::move(buffer));
+            operation.detach(
+                [owned, callback](status const &status_arg)
+                {
+                    callback(*owned, status_arg);
+                });
+        }
+    };
+}
+#endif
@@ -0,0 +1,126 @@
+#ifndef MPICPP_HEADER_HANDLES_PARTITIONED_REQUEST_HPP
+#define MPICPP_HEADER_HANDLES_PARTITIONED_REQUEST_HPP
+#pragma once
+
+#include <mpi.h>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "error/exception.hpp"
+
+namespace mpicxx
+{
+    // A partitioned send or receive (MPI_Psend_init/MPI_Precv_init). Once
+    // started, producer threads mark partitions with pready() as soon as
+    // they are filled, and the receiver may consume each partition as
+    // parrived() reports it, before the whole transfer has completed.
+    // Calling pready() or parrived() from several threads needs
+    // thread_level::multiple.
+    // Without MPI-4 every partition is an ordinary persistent send or receive
+    // tagged tag + partition, so the operation occupies the tags
+    // [tag, tag + partitions) on its communicator and both sides must use the
+    // same number of partitions.
+    class partitioned_request
+    {
+#if MPI_VERSION >= 4
+        MPI_Request implementation;
+#else
+        std::vector<MPI_Request> implementations;
+        bool receiving;
+#endif
+
+        void free();
+
+    public:
+#if MPI_VERSION >= 4
+        partitioned_request()
+            : implementation(MPI_REQUEST_NULL)
+        {
+        }
+        explicit partitioned_request(MPI_Request implementation_arg)
+            : implementation(implementation_arg)
+        {
+        }
+        partitioned_request(partitioned_request &&other) noexcept
+            : implementation(other.implementation)
+        {
+            other.implementation = MPI_REQUEST_NULL;
+        }
+#else
+        partitioned_request()
+            : receiving(false)
+        {
+        }
+        partitioned_request(std::vector<MPI_Request> implementations_arg, bool receiving_arg)
+            : implementations(std::move(implementations_arg)), receiving(receiving_arg)
+        {
+        }
+        partitioned_request(partitioned_request &&other) noexcept
+            : implementations(std::move(other.implementations)), receiving(other.receiving)
+        {
+            other.implementations.clear();
+        }
+#endif
+        partitioned_request(partitioned_request const &) = delete;
+        partitioned_request &operator=(partitioned_request const &) = delete;
+        partitioned_request &operator=(partitioned_request &&other);
+        ~partitioned_request();
+        void start();
+        void pready(int partition);
+        // Marks the partitions partition_low to partition_high inclusive.
+        void pready_range(int partition_low, int partition_high);
+        bool parrived(int partition);
+        void wait();
+        bool test();
+    };
+
+    // Owns the buffer of a partitioned operation, split into partitions()
+    // equal parts of partition_size() elements. The vector is moved in so
+    // its storage stays put while the operation uses it.
+    template <class T>
+    class partitioned_buffer
+    {
+        std::vector<T> buffer;
+        int partition_count;
+        // Declared after the buffer so it is waited on and freed first.
+        partitioned_request operation;
+
+    public:
+        partitioned_buffer(std::vector<T> &&buffer_arg, int partitions_arg, partitioned_request &&operation_arg)
+            : buffer(std::move(buffer_arg)), partition_count(partitions_arg), operation(std::move(operation_arg))
+        {
+        }
+        partitioned_buffer(partitioned_buffer &&other) noexcept = default;
+        partitioned_buffer &operator=(partitioned_buffer &&other)
+        {
+            operation = std::move(other.operation);
+            buffer = std::move(other.buffer);
+            partition_count = other.partition_count;
+            return *this;
+        }
+        int partitions() const { return partition_count; }
+        std::size_t partition_size() const { return buffer.size() / std::size_t(partition_count); }
+        T *partition(int index) { return buffer.data() + std::size_t(index) * partition_size(); }
+        T const *partition(int index) const { return buffer.data() + std::size_t(index) * partition_size(); }
+        T *data() { return buffer.data(); }
+        T const *data() const { return buffer.data(); }
+        std::size_t size() const { return buffer.size(); }
+        T &operator[](std::size_t index) { return buffer[index]; }
+        T const &operator[](std::size_t index) const { return buffer[index]; }
+        void start() { operation.start(); }
+        void ready(int index) { operation.pready(index); }
+        void ready(int index_low, int index_high) { operation.pready_range(index_low, index_high); }
+        bool arrived(int index) { return operation.parrived(index); }
+        void wait() { operation.wait(); }
+        bool test() { return operation.test(); }
+        // Waits for the current transfer, frees the operation and moves the
+        // buffer out.
+        std::vector<T> take()
+        {
+            operation = partitioned_request();
+            return std::move(buffer);
+        }
+    };
+}
+#endif
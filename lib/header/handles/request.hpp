@@ -2,29 +2,78 @@
 #define MPICPP_HEADER_REQUEST_REQUEST_HPP
 
 #include <mpi.h>
+#include <functional>
+#include <cstdint>
+#include <memory>
 #include "status.hpp"
+#include "instrumentation/instrumentation.hpp"
 
 namespace mpicxx
 {
+    class request_set;
+
+    namespace details
+    {
+        // Follow-up work attached to a request whose operation spans several
+        // MPI requests or owns state until completion. complete() runs each
+        // time the current MPI_Request finishes: it either starts the next
+        // phase by storing its handle and returning false, or returns true
+        // when the whole operation is done.
+        class request_continuation
+        {
+        public:
+            virtual ~request_continuation() = default;
+            virtual bool complete(MPI_Request &implementation) = 0;
+        };
+    }
+
     class request
     {
         MPI_Request implementation;
+        std::unique_ptr<details::request_continuation> continuation;
+#ifdef MPICXX_ENABLE_INSTRUMENTATION
+        details::instrumentation::counters *instrumented = details::instrumentation::current();
+#endif
+#ifdef MPICXX_ENABLE_TRACING
+        std::uint64_t trace_id = 0;
+        char const *trace_name = nullptr;
+        void trace_create();
+        void trace(details::tracing::event_kind kind) const;
+#endif
+
+        void advance();
+
+        friend class request_set;
+        friend void waitall(int count, request *array_of_requests);
 
     public:
         request()
             : implementation(MPI_REQUEST_NULL)
         {
         }
-        explicit constexpr request(MPI_Request implementation_arg)
+        explicit request(MPI_Request implementation_arg)
             : implementation(implementation_arg)
         {
+#ifdef MPICXX_ENABLE_TRACING
+            trace_create();
+#endif
         }
+        request(
+            MPI_Request implementation_arg,
+            std::unique_ptr<details::request_continuation> continuation_arg);
         request(request const &other);
         request &operator=(request const &other);
-        constexpr request(request &&other) noexcept
-            : implementation(other.implementation)
+        request(request &&other) noexcept
+            : implementation(other.implementation), continuation(std::move(other.continuation))
         {
             other.implementation = MPI_REQUEST_NULL;
+#ifdef MPICXX_ENABLE_INSTRUMENTATION
+            instrumented = other.instrumented;
+#endif
+#ifdef MPICXX_ENABLE_TRACING
+            trace_id = other.trace_id;
+            trace_name = other.trace_name;
+#endif
         }
         request &operator=(request &&other);
         void wait();
@@ -33,9 +82,56 @@ namespace mpicxx
         bool test(status &status_arg);
         ~request();
         MPI_Request &get() { return implementation; }
+        // Hands the MPI_Request over to the caller. Throws for requests with a
+        // continuation, whose remaining phases a raw handle cannot run.
+        MPI_Request release();
+        // Hands the request to the calling thread's completion_queue; the
+        // callback runs from mpicxx::progress() once the request completes.
+        void then(std::function<void(status const &)> callback);
+        // Gives the request up without waiting, so dropping it no longer
+        // blocks. The operation finishes in the background: it is reaped
+        // during later waits, tests and progress() calls and completed at the
+        // latest by comm::quiesce() or finalize. The buffers must stay valid
+        // until then; the optional callback runs once it has completed.
+        void detach();
+        void detach(std::function<void(status const &)> callback);
     };
 
+    // A persistent request is created once (send_init, recv_init, ...) and
+    // restarted with start() any number of times. Waiting only deactivates it;
+    // the handle is released by MPI_Request_free in the destructor.
+    class persistent_request
+    {
+        MPI_Request implementation;
+
+    public:
+        persistent_request()
+            : implementation(MPI_REQUEST_NULL)
+        {
+        }
+        explicit constexpr persistent_request(MPI_Request implementation_arg)
+            : implementation(implementation_arg)
+        {
+        }
+        persistent_request(persistent_request const &) = delete;
+        persistent_request &operator=(persistent_request const &) = delete;
+        constexpr persistent_request(persistent_request &&other) noexcept
+            : implementation(other.implementation)
+        {
+            other.implementation = MPI_REQUEST_NULL;
+        }
+        persistent_request &operator=(persistent_request &&other);
+        void start();
+        void wait();
+        bool test();
+        void wait(status &status_arg);
+        bool test(status &status_arg);
+        ~persistent_request();
+        MPI_Request &get() { return implementation; }
+    };
 
     void waitall(int count, request *array_of_requests);
+    void startall(int count, persistent_request *array_of_requests);
+    void waitall(int count, persistent_request *array_of_requests);
 }
 #endif
@@ -0,0 +1,63 @@
+#ifndef MPICPP_HEADER_HANDLES_REQUEST_SET_HPP
+#define MPICPP_HEADER_HANDLES_REQUEST_SET_HPP
+#pragma once
+
+#include <mpi.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "request.hpp"
+#include "status.hpp"
+
+namespace mpicxx
+{
+    // Owns a contiguous array of MPI_Request handles so completions can be
+    // harvested in batches with MPI_Waitany/Waitsome/Testsome/Testall.
+    // Index i always refers to the i-th inserted request until compact() is
+    // called; completed entries become MPI_REQUEST_NULL. The destructor waits
+    // on whatever is still outstanding, once, for the whole set.
+    // Requests carrying a continuation are only reported once their last
+    // phase has finished; until then their slot holds the next phase.
+    class request_set
+    {
+        std::vector<MPI_Request> implementations;
+        std::vector<std::unique_ptr<details::request_continuation>> continuations;
+        std::vector<MPI_Status> status_implementations;
+        std::size_t pending_continuations = 0;
+
+        bool finish(std::size_t index);
+        void drop_unfinished(std::vector<int> &indices, std::vector<MPI_Status> *statuses);
+
+    public:
+        request_set() = default;
+        request_set(request_set const &) = delete;
+        request_set &operator=(request_set const &) = delete;
+        request_set(request_set &&other) noexcept;
+        request_set &operator=(request_set &&other);
+        ~request_set();
+        std::size_t insert(request &&request_arg);
+        request release(std::size_t index);
+        void reserve(std::size_t capacity)
+        {
+            implementations.reserve(capacity);
+            continuations.reserve(capacity);
+        }
+        std::size_t size() const { return implementations.size(); }
+        bool empty() const { return implementations.empty(); }
+        void compact();
+        int wait_any();
+        int wait_any(status &status_arg);
+        void wait_some(std::vector<int> &indices);
+        void wait_some(std::vector<int> &indices, std::vector<status> &statuses);
+        void test_some(std::vector<int> &indices);
+        void test_some(std::vector<int> &indices, std::vector<status> &statuses);
+        bool test_all();
+        bool test_all(std::vector<status> &statuses);
+        void wait_all();
+        MPI_Request &get(std::size_t index) { return implementations[index]; }
+        MPI_Request *data() { return implementations.data(); }
+    };
+}
+
+#endif
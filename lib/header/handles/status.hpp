@@ -3,6 +3,9 @@
 
 #include <mpi.h>
 
+#include "datatype/datatype.hpp"
+#include "error/exception.hpp"
+
 namespace mpicxx
 {
     class status
@@ -17,6 +20,19 @@ namespace mpicxx
         int source() const { return implementation.MPI_SOURCE; }
         int tag() const { return implementation.MPI_TAG; }
         int error() const { return implementation.MPI_ERROR; }
+        // Number of received elements, or MPI_UNDEFINED if the message is not
+        // a whole number of them.
+        int get_count(datatype const &datatype_arg) const
+        {
+            int count;
+            handle_error(MPI_Get_count(&implementation, datatype_arg.get(), &count));
+            return count;
+        }
+        template <class T>
+        int get_count() const
+        {
+            return get_count(predefined_datatype<T>());
+        }
     };
 }
 #endif
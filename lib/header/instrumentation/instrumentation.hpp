@@ -0,0 +1,76 @@
+#ifndef MPICPP_HEADER_INSTRUMENTATION_INSTRUMENTATION_HPP
+#define MPICPP_HEADER_INSTRUMENTATION_INSTRUMENTATION_HPP
+#pragma once
+
+#include <mpi.h>
+
+#include "instrumentation/tracing.hpp"
+
+// Opt-in per-communicator counters, compiled in only when the library is
+// configured with -DMPICXX_INSTRUMENTATION=ON. Every instrumented comm
+// operation counts calls, bytes and the time spent starting it, bucketed by
+// (communicator name, operation, log2 message size); the requests it returns
+// add the time spent in wait/test/waitall to the same bucket. At finalize the
+// buckets are summed across MPI_COMM_WORLD and rank 0 writes them as JSON to
+// $MPICXX_INSTRUMENTATION_FILE (default mpicxx_instrumentation.json).
+// Persistent requests and request_set waits are not attributed.
+
+#ifdef MPICXX_ENABLE_INSTRUMENTATION
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace mpicxx
+{
+    namespace details
+    {
+        namespace instrumentation
+        {
+            struct counters
+            {
+                std::atomic<std::uint64_t> calls{0};
+                std::atomic<std::uint64_t> bytes{0};
+                std::atomic<std::uint64_t> initiation_nanoseconds{0};
+                std::atomic<std::uint64_t> wait_nanoseconds{0};
+            };
+
+            // The bucket of the operation being started on this thread, which
+            // requests constructed meanwhile are attributed to.
+            counters *current();
+            void add_wait(counters *record, double seconds);
+            std::size_t total(int const counts[], int count);
+            // Collective over MPI_COMM_WORLD; called by environment finalize.
+            void report();
+
+            class scope
+            {
+                counters *record = nullptr;
+                double start;
+
+            public:
+                scope(MPI_Comm comm, char const *operation, std::size_t count, MPI_Datatype datatype);
+                scope(scope const &) = delete;
+                scope &operator=(scope const &) = delete;
+                ~scope();
+            };
+        }
+    }
+}
+
+#define MPICXX_COUNT_OPERATION(operation, comm, count, datatype)                 \
+    ::mpicxx::details::instrumentation::scope mpicxx_instrumentation_scope(      \
+        comm, operation, count, datatype)
+
+#else
+
+#define MPICXX_COUNT_OPERATION(operation, comm, count, datatype) ((void)0)
+
+#endif
+
+// Marks the start of a comm operation for the counters and the tracer.
+#define MPICXX_INSTRUMENT(operation, comm, count, datatype)                      \
+    MPICXX_COUNT_OPERATION(operation, comm, count, datatype);                    \
+    MPICXX_TRACE_OPERATION(operation)
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef MPICPP_HEADER_INSTRUMENTATION_TRACING_HPP
+#define MPICPP_HEADER_INSTRUMENTATION_TRACING_HPP
+#pragma once
+
+// Opt-in request timeline tracing, compiled in only when the library is
+// configured with -DMPICXX_TRACING=ON. Requests record their creation (named
+// after the comm operation that started them), every test, every wait (with
+// the waits hidden in ~request and move assignment marked as implicit) and
+// their completion into a fixed-size ring buffer owned by the recording
+// thread. At finalize each rank
+// writes $MPICXX_TRACE_PREFIX.<rank>.json (default prefix mpicxx_trace) in
+// Chrome trace format, loadable in chrome://tracing or Perfetto. Timestamps
+// are shifted by per-rank MPI_Wtime offsets to rank 0, estimated by
+// ping-pong at startup, so the files of all ranks line up when loaded
+// together.
+
+#ifdef MPICXX_ENABLE_TRACING
+
+#include <cstdint>
+
+namespace mpicxx
+{
+    namespace details
+    {
+        namespace tracing
+        {
+            enum class event_kind : unsigned char
+            {
+                create,
+                test,
+                wait_begin,
+                implicit_wait_begin,
+                wait_end,
+                complete
+            };
+
+            // Name of the comm operation being started on this thread; the
+            // outermost operation wins when one forwards to another.
+            inline thread_local char const *current_operation = nullptr;
+
+            class operation_scope
+            {
+                char const *previous;
+
+            public:
+                explicit operation_scope(char const *operation)
+                    : previous(current_operation)
+                {
+                    if (!previous)
+                    {
+                        current_operation = operation;
+                    }
+                }
+                operation_scope(operation_scope const &) = delete;
+                operation_scope &operator=(operation_scope const &) = delete;
+                ~operation_scope()
+                {
+                    current_operation = previous;
+                }
+            };
+
+            std::uint64_t next_id();
+            void record(event_kind kind, std::uint64_t id, char const *name);
+            // Collective over MPI_COMM_WORLD, called by environment after
+            // MPI_Init and before MPI_Finalize.
+            void start();
+            void finish();
+        }
+    }
+}
+
+#define MPICXX_TRACE_OPERATION(operation) \
+    ::mpicxx::details::tracing::operation_scope mpicxx_tracing_scope(operation)
+
+#else
+
+#define MPICXX_TRACE_OPERATION(operation) ((void)0)
+
+#endif
+
+#endif
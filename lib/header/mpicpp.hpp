@@ -9,10 +9,23 @@
 #include <mpienv/environment.hpp>
 #include <datatype/datatype.hpp>
 #include <communicators/comm.hpp>
+#include <communicators/halo_exchange.hpp>
+#include <communicators/hierarchical_comm.hpp>
 #include <handles/request.hpp>
+#include <handles/request_set.hpp>
+#include <handles/completion_queue.hpp>
+#include <coroutines/task.hpp>
 #include <handles/status.hpp>
+#include <handles/message.hpp>
+#include <handles/owning_request.hpp>
+#include <handles/partitioned_request.hpp>
+#include <onesided/epoch.hpp>
+#include <onesided/window.hpp>
+#include <onesided/shared_array.hpp>
+#include <containers/dist_vector.hpp>
 
 #include <reductionoperation/reductionop.hpp>
+#include <serialization/serialization.hpp>
 
 
 #endif
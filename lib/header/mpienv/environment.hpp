@@ -3,14 +3,43 @@
 #pragma once
 
 #include <mpi.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 namespace mpicxx
 {
+    enum class thread_level : int
+    {
+        single = MPI_THREAD_SINGLE,
+        funneled = MPI_THREAD_FUNNELED,
+        serialized = MPI_THREAD_SERIALIZED,
+        multiple = MPI_THREAD_MULTIPLE
+    };
+
     class [[nodiscard]] environment
     {
+        thread_level provided;
+        std::thread progress_thread;
+        std::atomic<bool> progress_running;
+        MPI_Comm progress_comm;
+
+        void initialize(int *argc, char ***argv, int required);
+        void query_thread_level();
+
     public:
         environment(int& argc,char**& argv);
+        environment(int &argc, char **&argv, thread_level required);
         environment();
+        explicit environment(thread_level required);
+        thread_level provided_thread_level() const { return provided; }
+        // Spawns a thread that repeatedly enters the MPI progress engine so
+        // outstanding nonblocking operations advance while the caller computes.
+        // Requires thread_level::multiple. A zero interval spins with yield.
+        void start_progress_thread(
+            std::chrono::microseconds poll_interval = std::chrono::microseconds(0));
+        void stop_progress_thread();
+        bool progress_thread_running() const { return progress_thread.joinable(); }
         void finalize();
         ~environment();
         environment(environment const &) = delete;
@@ -0,0 +1,85 @@
+#ifndef MPICPP_HEADER_ONESIDED_EPOCH_HPP
+#define MPICPP_HEADER_ONESIDED_EPOCH_HPP
+#pragma once
+
+#include <mpi.h>
+#include <vector>
+
+namespace mpicxx
+{
+    // RAII access and exposure epochs on an MPI_Win. Each guard opens the
+    // epoch in its constructor and closes it in its destructor, which is
+    // where the RMA operations issued inside it are guaranteed complete.
+
+    class [[nodiscard]] fence_epoch
+    {
+        MPI_Win implementation;
+        int close_assert;
+
+    public:
+        fence_epoch(MPI_Win implementation_arg, int open_assert = 0, int close_assert_arg = 0);
+        ~fence_epoch();
+        fence_epoch(fence_epoch const &) = delete;
+        fence_epoch &operator=(fence_epoch const &) = delete;
+        fence_epoch(fence_epoch &&) = delete;
+        fence_epoch &operator=(fence_epoch &&) = delete;
+    };
+
+    class [[nodiscard]] lock_epoch
+    {
+        MPI_Win implementation;
+        int rank;
+
+    public:
+        lock_epoch(MPI_Win implementation_arg, int rank_arg, int lock_type = MPI_LOCK_SHARED, int assert_arg = 0);
+        ~lock_epoch();
+        lock_epoch(lock_epoch const &) = delete;
+        lock_epoch &operator=(lock_epoch const &) = delete;
+        lock_epoch(lock_epoch &&) = delete;
+        lock_epoch &operator=(lock_epoch &&) = delete;
+    };
+
+    class [[nodiscard]] lock_all_epoch
+    {
+        MPI_Win implementation;
+
+    public:
+        explicit lock_all_epoch(MPI_Win implementation_arg, int assert_arg = 0);
+        ~lock_all_epoch();
+        lock_all_epoch(lock_all_epoch const &) = delete;
+        lock_all_epoch &operator=(lock_all_epoch const &) = delete;
+        lock_all_epoch(lock_all_epoch &&) = delete;
+        lock_all_epoch &operator=(lock_all_epoch &&) = delete;
+    };
+
+    // Post-start-complete-wait: the origin side opens an access epoch to the
+    // listed target ranks, the target side exposes its window to the listed
+    // origin ranks. Ranks are relative to the window's communicator.
+    class [[nodiscard]] access_epoch
+    {
+        MPI_Win implementation;
+
+    public:
+        access_epoch(MPI_Win implementation_arg, std::vector<int> const &target_ranks, int assert_arg = 0);
+        ~access_epoch();
+        access_epoch(access_epoch const &) = delete;
+        access_epoch &operator=(access_epoch const &) = delete;
+        access_epoch(access_epoch &&) = delete;
+        access_epoch &operator=(access_epoch &&) = delete;
+    };
+
+    class [[nodiscard]] exposure_epoch
+    {
+        MPI_Win implementation;
+
+    public:
+        exposure_epoch(MPI_Win implementation_arg, std::vector<int> const &origin_ranks, int assert_arg = 0);
+        ~exposure_epoch();
+        exposure_epoch(exposure_epoch const &) = delete;
+        exposure_epoch &operator=(exposure_epoch const &) = delete;
+        exposure_epoch(exposure_epoch &&) = delete;
+        exposure_epoch &operator=(exposure_epoch &&) = delete;
+    };
+}
+
+#endif
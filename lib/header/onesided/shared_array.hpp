@@ -0,0 +1,125 @@
+#ifndef MPICPP_HEADER_ONESIDED_SHARED_ARRAY_HPP
+#define MPICPP_HEADER_ONESIDED_SHARED_ARRAY_HPP
+#pragma once
+
+#include <mpi.h>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "communicators/comm.hpp"
+#include "error/exception.hpp"
+
+namespace mpicxx
+{
+    // Memory shared by all ranks of a node communicator through
+    // MPI_Win_allocate_shared. Every rank contributes local_count elements
+    // and gets direct load/store pointers to each peer's segment; segments are
+    // contiguous in node-rank order, so segment(0) addresses the whole array.
+    // A passive epoch is held open for the lifetime of the array: use sync()
+    // to order one's own stores and barrier() to publish them to the node.
+    template <class T>
+    class shared_array
+    {
+        comm node;
+        int rank_in_node;
+        MPI_Win implementation;
+        std::vector<T *> segments;
+        std::vector<std::size_t> counts;
+
+        void release()
+        {
+            if (implementation != MPI_WIN_NULL)
+            {
+                handle_error(MPI_Win_unlock_all(implementation));
+                handle_error(MPI_Win_free(&implementation));
+            }
+        }
+
+    public:
+        // node_arg must span ranks that can share memory, e.g. the result of
+        // split_type(MPI_COMM_TYPE_SHARED, ...).
+        shared_array(comm &&node_arg, std::size_t local_count, MPI_Info info = MPI_INFO_NULL)
+            : node(std::move(node_arg)), rank_in_node(node.rank()), implementation(MPI_WIN_NULL)
+        {
+            T *local_base;
+            handle_error(
+                MPI_Win_allocate_shared(
+                    MPI_Aint(local_count * sizeof(T)),
+                    int(sizeof(T)),
+                    info,
+                    node.get(),
+                    &local_base,
+                    &implementation));
+            handle_error(MPI_Win_lock_all(MPI_MODE_NOCHECK, implementation));
+            int node_size = node.size();
+            segments.resize(node_size);
+            counts.resize(node_size);
+            for (int peer = 0; peer < node_size; ++peer)
+            {
+                MPI_Aint segment_bytes;
+                int disp_unit;
+                handle_error(
+                    MPI_Win_shared_query(
+                        implementation,
+                        peer,
+                        &segment_bytes,
+                        &disp_unit,
+                        &segments[peer]));
+                counts[peer] = std::size_t(segment_bytes) / sizeof(T);
+            }
+        }
+        static shared_array on_node(comm const &parent, std::size_t local_count, MPI_Info info = MPI_INFO_NULL)
+        {
+            return shared_array(parent.split_type(MPI_COMM_TYPE_SHARED, parent.rank()), local_count, info);
+        }
+        shared_array(shared_array const &) = delete;
+        shared_array &operator=(shared_array const &) = delete;
+        shared_array(shared_array &&other) noexcept
+            : node(std::move(other.node)),
+              rank_in_node(other.rank_in_node),
+              implementation(other.implementation),
+              segments(std::move(other.segments)),
+              counts(std::move(other.counts))
+        {
+            other.implementation = MPI_WIN_NULL;
+        }
+        shared_array &operator=(shared_array &&other)
+        {
+            release();
+            node = std::move(other.node);
+            rank_in_node = other.rank_in_node;
+            implementation = other.implementation;
+            segments = std::move(other.segments);
+            counts = std::move(other.counts);
+            other.implementation = MPI_WIN_NULL;
+            return *this;
+        }
+        ~shared_array()
+        {
+            release();
+        }
+
+        comm const &node_comm() const { return node; }
+        int node_rank() const { return rank_in_node; }
+        int node_size() const { return int(segments.size()); }
+        T *data() { return segments[rank_in_node]; }
+        std::size_t size() const { return counts[rank_in_node]; }
+        T *segment(int peer) const { return segments[peer]; }
+        std::size_t segment_size(int peer) const { return counts[peer]; }
+        MPI_Win get() const { return implementation; }
+
+        void sync() const
+        {
+            handle_error(MPI_Win_sync(implementation));
+        }
+        void barrier() const
+        {
+            sync();
+            node.ibarrier().wait();
+            sync();
+        }
+    };
+}
+
+#endif
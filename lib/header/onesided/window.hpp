@@ -0,0 +1,259 @@
+#ifndef MPICPP_HEADER_ONESIDED_WINDOW_HPP
+#define MPICPP_HEADER_ONESIDED_WINDOW_HPP
+#pragma once
+
+#include <mpi.h>
+#include <cstddef>
+#include <vector>
+
+#include "communicators/comm.hpp"
+#include "datatype/datatype.hpp"
+#include "error/exception.hpp"
+#include "handles/request.hpp"
+#include "onesided/epoch.hpp"
+#include "reductionoperation/reductionop.hpp"
+
+namespace mpicxx
+{
+    // A one-sided communication window over count elements of T per rank.
+    // Target displacements are in elements of T. The window is freed
+    // (collectively) in the destructor, together with its memory when it was
+    // obtained through allocate().
+    template <class T>
+    class window
+    {
+        MPI_Win implementation;
+        T *base;
+        std::size_t count;
+
+        window(MPI_Win implementation_arg, T *base_arg, std::size_t count_arg)
+            : implementation(implementation_arg), base(base_arg), count(count_arg)
+        {
+        }
+
+    public:
+        window()
+            : implementation(MPI_WIN_NULL), base(nullptr), count(0)
+        {
+        }
+        window(window const &) = delete;
+        window &operator=(window const &) = delete;
+        window(window &&other) noexcept
+            : implementation(other.implementation), base(other.base), count(other.count)
+        {
+            other.implementation = MPI_WIN_NULL;
+            other.base = nullptr;
+            other.count = 0;
+        }
+        window &operator=(window &&other)
+        {
+            if (implementation != MPI_WIN_NULL)
+            {
+                handle_error(MPI_Win_free(&implementation));
+            }
+            implementation = other.implementation;
+            base = other.base;
+            count = other.count;
+            other.implementation = MPI_WIN_NULL;
+            other.base = nullptr;
+            other.count = 0;
+            return *this;
+        }
+        ~window()
+        {
+            if (implementation != MPI_WIN_NULL)
+            {
+                handle_error(MPI_Win_free(&implementation));
+            }
+        }
+
+        static window allocate(comm const &comm_arg, std::size_t count_arg, MPI_Info info = MPI_INFO_NULL)
+        {
+            MPI_Win new_implementation;
+            T *new_base;
+            handle_error(
+                MPI_Win_allocate(
+                    MPI_Aint(count_arg * sizeof(T)),
+                    int(sizeof(T)),
+                    info,
+                    comm_arg.get(),
+                    &new_base,
+                    &new_implementation));
+            return window(new_implementation, new_base, count_arg);
+        }
+
+        static window create(comm const &comm_arg, T *base_arg, std::size_t count_arg, MPI_Info info = MPI_INFO_NULL)
+        {
+            MPI_Win new_implementation;
+            handle_error(
+                MPI_Win_create(
+                    base_arg,
+                    MPI_Aint(count_arg * sizeof(T)),
+                    int(sizeof(T)),
+                    info,
+                    comm_arg.get(),
+                    &new_implementation));
+            return window(new_implementation, base_arg, count_arg);
+        }
+
+        T *data() { return base; }
+        T const *data() const { return base; }
+        std::size_t size() const { return count; }
+        MPI_Win get() const { return implementation; }
+
+        fence_epoch fence(int open_assert = 0, int close_assert = 0) const
+        {
+            return fence_epoch(implementation, open_assert, close_assert);
+        }
+        lock_epoch lock(int rank, int lock_type = MPI_LOCK_SHARED, int assert_arg = 0) const
+        {
+            return lock_epoch(implementation, rank, lock_type, assert_arg);
+        }
+        lock_all_epoch lock_all(int assert_arg = 0) const
+        {
+            return lock_all_epoch(implementation, assert_arg);
+        }
+        access_epoch start(std::vector<int> const &target_ranks, int assert_arg = 0) const
+        {
+            return access_epoch(implementation, target_ranks, assert_arg);
+        }
+        exposure_epoch post(std::vector<int> const &origin_ranks, int assert_arg = 0) const
+        {
+            return exposure_epoch(implementation, origin_ranks, assert_arg);
+        }
+
+        void put(T const *origin, int origin_count, int target_rank, MPI_Aint target_disp) const
+        {
+            datatype datatype_arg = predefined_datatype<T>();
+            handle_error(
+                MPI_Put(
+                    origin,
+                    origin_count,
+                    datatype_arg.get(),
+                    target_rank,
+                    target_disp,
+                    origin_count,
+                    datatype_arg.get(),
+                    implementation));
+        }
+        void get(T *origin, int origin_count, int target_rank, MPI_Aint target_disp) const
+        {
+            datatype datatype_arg = predefined_datatype<T>();
+            handle_error(
+                MPI_Get(
+                    origin,
+                    origin_count,
+                    datatype_arg.get(),
+                    target_rank,
+                    target_disp,
+                    origin_count,
+                    datatype_arg.get(),
+                    implementation));
+        }
+        void accumulate(T const *origin, int origin_count, int target_rank, MPI_Aint target_disp, op const &op_arg) const
+        {
+            datatype datatype_arg = predefined_datatype<T>();
+            handle_error(
+                MPI_Accumulate(
+                    origin,
+                    origin_count,
+                    datatype_arg.get(),
+                    target_rank,
+                    target_disp,
+                    origin_count,
+                    datatype_arg.get(),
+                    op_arg.get(),
+                    implementation));
+        }
+
+        // Request-based operations are only valid inside a passive-target
+        // (lock or lock_all) epoch. Completing the request means the origin
+        // buffer may be reused (rput, raccumulate) or holds the data (rget).
+        request rput(T const *origin, int origin_count, int target_rank, MPI_Aint target_disp) const
+        {
+            datatype datatype_arg = predefined_datatype<T>();
+            MPI_Request request_implementation;
+            handle_error(
+                MPI_Rput(
+                    origin,
+                    origin_count,
+                    datatype_arg.get(),
+                    target_rank,
+                    target_disp,
+                    origin_count,
+                    datatype_arg.get(),
+                    implementation,
+                    &request_implementation));
+            return request(request_implementation);
+        }
+        request rget(T *origin, int origin_count, int target_rank, MPI_Aint target_disp) const
+        {
+            datatype datatype_arg = predefined_datatype<T>();
+            MPI_Request request_implementation;
+            handle_error(
+                MPI_Rget(
+                    origin,
+                    origin_count,
+                    datatype_arg.get(),
+                    target_rank,
+                    target_disp,
+                    origin_count,
+                    datatype_arg.get(),
+                    implementation,
+                    &request_implementation));
+            return request(request_implementation);
+        }
+        request raccumulate(T const *origin, int origin_count, int target_rank, MPI_Aint target_disp, op const &op_arg) const
+        {
+            datatype datatype_arg = predefined_datatype<T>();
+            MPI_Request request_implementation;
+            handle_error(
+                MPI_Raccumulate(
+                    origin,
+                    origin_count,
+                    datatype_arg.get(),
+                    target_rank,
+                    target_disp,
+                    origin_count,
+                    datatype_arg.get(),
+                    op_arg.get(),
+                    implementation,
+                    &request_implementation));
+            return request(request_implementation);
+        }
+
+        // Atomic single-element operations; result is valid after the next
+        // flush or epoch close.
+        void fetch_and_op(T const &value, T &result, int target_rank, MPI_Aint target_disp, op const &op_arg) const
+        {
+            handle_error(
+                MPI_Fetch_and_op(
+                    &value,
+                    &result,
+                    predefined_datatype<T>().get(),
+                    target_rank,
+                    target_disp,
+                    op_arg.get(),
+                    implementation));
+        }
+        void compare_and_swap(T const &value, T const &compare, T &result, int target_rank, MPI_Aint target_disp) const
+        {
+            handle_error(
+                MPI_Compare_and_swap(
+                    &value,
+                    &compare,
+                    &result,
+                    predefined_datatype<T>().get(),
+                    target_rank,
+                    target_disp,
+                    implementation));
+        }
+
+        void flush(int rank) const { handle_error(MPI_Win_flush(rank, implementation)); }
+        void flush_all() const { handle_error(MPI_Win_flush_all(implementation)); }
+        void flush_local(int rank) const { handle_error(MPI_Win_flush_local(rank, implementation)); }
+        void sync() const { handle_error(MPI_Win_sync(implementation)); }
+    };
+}
+
+#endif
@@ -3,9 +3,54 @@
 #pragma once
 
 #include <mpi.h>
+#include <optional>
+#include <type_traits>
+
+#include "error/exception.hpp"
 
 namespace mpicxx
 {
+    namespace details
+    {
+        void register_cached_op(MPI_Op implementation);
+        void free_cached_ops();
+
+        template <class Functor>
+        struct reduction_functor
+        {
+            static inline std::optional<Functor> instance;
+        };
+
+        // MPI_User_function for op::from: a plain typed loop over the
+        // buffers with the functor inlined, which the compiler can unroll
+        // and vectorize.
+        template <class T, class Functor>
+        void typed_reduction(void *invec, void *inoutvec, int *len, MPI_Datatype *)
+        {
+            Functor const &functor = *reduction_functor<Functor>::instance;
+            T const *__restrict in = static_cast<T const *>(invec);
+            T *__restrict inout = static_cast<T *>(inoutvec);
+            int const count = *len;
+            for (int i = 0; i < count; ++i)
+            {
+                inout[i] = functor(in[i], inout[i]);
+            }
+        }
+
+        template <class T, class Functor, bool Commute>
+        MPI_Op cached_op()
+        {
+            static MPI_Op const implementation = []
+            {
+                MPI_Op created;
+                handle_error(MPI_Op_create(&typed_reduction<T, Functor>, Commute, &created));
+                register_cached_op(created);
+                return created;
+            }();
+            return implementation;
+        }
+    }
+
     class op
   {
     MPI_Op implementation;
@@ -39,6 +84,25 @@ namespace mpicxx
     static op create(
         MPI_User_function *user_f,
         int commute = 1);
+    // Reduction over elements of type T combining (in, inout) into a new
+    // inout value, e.g.
+    //   op::from<double>([](double a, double b) { return a > b ? a : b; })
+    // T may be any type with a predefined_datatype, including structs
+    // registered with MPICXX_REGISTER_STRUCT, so (value, index) pairs or
+    // min/max/sum records reduce in one pass. The functor must be stateless;
+    // one MPI_Op is created per functor type and freed at finalize.
+    template <class T, class Functor>
+    static op from(
+        Functor functor,
+        bool commute = true)
+    {
+      static_assert(std::is_empty<Functor>::value, "op::from needs a stateless functor");
+      static bool const stored = (details::reduction_functor<Functor>::instance.emplace(functor), true);
+      (void)stored;
+      return op(commute ? details::cached_op<T, Functor, true>()
+                        : details::cached_op<T, Functor, false>(),
+                false);
+    }
   };
 
 } // namespace mpicxx
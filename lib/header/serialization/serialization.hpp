@@ -0,0 +1,463 @@
+#ifndef MPICPP_HEADER_SERIALIZATION_SERIALIZATION_HPP
+#define MPICPP_HEADER_SERIALIZATION_SERIALIZATION_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "error/exception.hpp"
+
+namespace mpicxx
+{
+    // Byte-level encoding of a C++ value for transfer as MPI_BYTE.
+    // Specializations provide
+    //   static std::size_t size(T const &);
+    //   static void write(T const &, char *&out);
+    //   static void read(char const *&in, char const *end, T &);
+    // write may assume out has room for size() bytes; read advances in and
+    // must not pass end. Trivially copyable types are copied bytewise;
+    // strings, vectors, pairs and maps are provided below, and aggregates can
+    // opt in with MPICXX_SERIALIZE_MEMBERS.
+    template <class T, class Enable = void>
+    struct serializer;
+
+    namespace details
+    {
+        inline void read_bytes(char const *&in, char const *end, void *out, std::size_t bytes)
+        {
+            if (std::size_t(end - in) < bytes)
+            {
+                throw exception("mpicxx: truncated serialized buffer");
+            }
+            if (bytes != 0)
+            {
+                std::memcpy(out, in, bytes);
+            }
+            in += bytes;
+        }
+
+        inline void write_bytes(char *&out, void const *in, std::size_t bytes)
+        {
+            if (bytes != 0)
+            {
+                std::memcpy(out, in, bytes);
+            }
+            out += bytes;
+        }
+
+        inline std::uint64_t read_length(char const *&in, char const *end)
+        {
+            std::uint64_t length;
+            read_bytes(in, end, &length, sizeof(length));
+            return length;
+        }
+
+        // Contiguous containers of trivially copyable elements: their bytes
+        // can be sent from, and received into, the container's own storage.
+        template <class T>
+        struct is_contiguous_trivial : std::false_type
+        {
+        };
+
+        template <class U, class A>
+        struct is_contiguous_trivial<std::vector<U, A>>
+            : std::integral_constant<bool, std::is_trivially_copyable<U>::value && !std::is_same<U, bool>::value>
+        {
+        };
+
+        template <class C, class Tr, class A>
+        struct is_contiguous_trivial<std::basic_string<C, Tr, A>> : std::true_type
+        {
+        };
+
+        template <class T>
+        struct contiguous_element;
+
+        template <class U, class A>
+        struct contiguous_element<std::vector<U, A>>
+        {
+            using type = U;
+        };
+
+        template <class C, class Tr, class A>
+        struct contiguous_element<std::basic_string<C, Tr, A>>
+        {
+            using type = C;
+        };
+
+        template <class Container>
+        struct contiguous_serializer
+        {
+            using element = typename contiguous_element<Container>::type;
+
+            static std::size_t size(Container const &value)
+            {
+                return sizeof(std::uint64_t) + value.size() * sizeof(element);
+            }
+            static void write(Container const &value, char *&out)
+            {
+                std::uint64_t length = value.size();
+                write_bytes(out, &length, sizeof(length));
+                write_bytes(out, value.data(), value.size() * sizeof(element));
+            }
+            static void read(char const *&in, char const *end, Container &value)
+            {
+                std::uint64_t length = read_length(in, end);
+                if (std::uint64_t(end - in) / sizeof(element) < length)
+                {
+                    throw exception("mpicxx: truncated serialized buffer");
+                }
+                value.resize(std::size_t(length));
+                read_bytes(in, end, length == 0 ? nullptr : &value[0], std::size_t(length) * sizeof(element));
+            }
+        };
+
+        // A vector of contiguous trivial ranges (e.g. std::vector<std::string>)
+        // is flattened into one block: the element count, a table of count + 1
+        // byte offsets, then every element's bytes back to back. ragged_view
+        // reads this layout in place.
+        template <class Container>
+        struct ragged_serializer
+        {
+            using inner = typename Container::value_type;
+            using element = typename contiguous_element<inner>::type;
+
+            static std::size_t size(Container const &value)
+            {
+                std::size_t bytes = sizeof(std::uint64_t) * (value.size() + 2);
+                for (auto const &item : value)
+                {
+                    bytes += item.size() * sizeof(element);
+                }
+                return bytes;
+            }
+            static void write(Container const &value, char *&out)
+            {
+                std::uint64_t length = value.size();
+                write_bytes(out, &length, sizeof(length));
+                std::uint64_t offset = 0;
+                write_bytes(out, &offset, sizeof(offset));
+                for (auto const &item : value)
+                {
+                    offset += item.size() * sizeof(element);
+                    write_bytes(out, &offset, sizeof(offset));
+                }
+                for (auto const &item : value)
+                {
+                    write_bytes(out, item.data(), item.size() * sizeof(element));
+                }
+            }
+            static void read(char const *&in, char const *end, Container &value)
+            {
+                std::uint64_t length = read_length(in, end);
+                if (std::uint64_t(end - in) / sizeof(std::uint64_t) <= length)
+                {
+                    throw exception("mpicxx: truncated serialized buffer");
+                }
+                char const *offsets = in;
+                in += sizeof(std::uint64_t) * (length + 1);
+                char const *data = in;
+                value.resize(std::size_t(length));
+                std::uint64_t first;
+                std::memcpy(&first, offsets, sizeof(first));
+                for (std::size_t i = 0; i < value.size(); ++i)
+                {
+                    std::uint64_t last;
+                    std::memcpy(&last, offsets + sizeof(std::uint64_t) * (i + 1), sizeof(last));
+                    if (last < first || std::uint64_t(end - data) < last)
+                    {
+                        throw exception("mpicxx: corrupt serialized offsets table");
+                    }
+                    value[i].resize(std::size_t((last - first) / sizeof(element)));
+                    char const *item = data + first;
+                    read_bytes(item, data + last, value[i].empty() ? nullptr : &value[i][0], value[i].size() * sizeof(element));
+                    first = last;
+                }
+                in = data + first;
+            }
+        };
+
+        template <class Container>
+        struct sequence_serializer
+        {
+            static std::size_t size(Container const &value)
+            {
+                std::size_t bytes = sizeof(std::uint64_t);
+                for (auto const &item : value)
+                {
+                    bytes += serializer<typename Container::value_type>::size(item);
+                }
+                return bytes;
+            }
+            static void write(Container const &value, char *&out)
+            {
+                std::uint64_t length = value.size();
+                write_bytes(out, &length, sizeof(length));
+                for (auto const &item : value)
+                {
+                    serializer<typename Container::value_type>::write(item, out);
+                }
+            }
+            static void read(char const *&in, char const *end, Container &value)
+            {
+                std::uint64_t length = read_length(in, end);
+                value.clear();
+                value.resize(std::size_t(length));
+                for (auto &item : value)
+                {
+                    serializer<typename Container::value_type>::read(in, end, item);
+                }
+            }
+        };
+
+        template <class Map>
+        struct map_serializer
+        {
+            using key = typename Map::key_type;
+            using mapped = typename Map::mapped_type;
+
+            static std::size_t size(Map const &value)
+            {
+                std::size_t bytes = sizeof(std::uint64_t);
+                for (auto const &item : value)
+                {
+                    bytes += serializer<key>::size(item.first) + serializer<mapped>::size(item.second);
+                }
+                return bytes;
+            }
+            static void write(Map const &value, char *&out)
+            {
+                std::uint64_t length = value.size();
+                write_bytes(out, &length, sizeof(length));
+                for (auto const &item : value)
+                {
+                    serializer<key>::write(item.first, out);
+                    serializer<mapped>::write(item.second, out);
+                }
+            }
+            static void read(char const *&in, char const *end, Map &value)
+            {
+                std::uint64_t length = read_length(in, end);
+                value.clear();
+                for (std::uint64_t i = 0; i < length; ++i)
+                {
+                    key k;
+                    serializer<key>::read(in, end, k);
+                    serializer<mapped>::read(in, end, value[std::move(k)]);
+                }
+            }
+        };
+
+        template <class T, auto... Members>
+        struct member_serializer
+        {
+            static std::size_t size(T const &value)
+            {
+                return (std::size_t(0) + ... + serializer<std::decay_t<decltype(value.*Members)>>::size(value.*Members));
+            }
+            static void write(T const &value, char *&out)
+            {
+                (serializer<std::decay_t<decltype(value.*Members)>>::write(value.*Members, out), ...);
+            }
+            static void read(char const *&in, char const *end, T &value)
+            {
+                (serializer<std::decay_t<decltype(value.*Members)>>::read(in, end, value.*Members), ...);
+            }
+        };
+    }
+
+    template <class T>
+    struct serializer<T, std::enable_if_t<std::is_trivially_copyable<T>::value>>
+    {
+        static std::size_t size(T const &) { return sizeof(T); }
+        static void write(T const &value, char *&out) { details::write_bytes(out, &value, sizeof(T)); }
+        static void read(char const *&in, char const *end, T &value) { details::read_bytes(in, end, &value, sizeof(T)); }
+    };
+
+    template <class C, class Tr, class A>
+    struct serializer<std::basic_string<C, Tr, A>>
+        : details::contiguous_serializer<std::basic_string<C, Tr, A>>
+    {
+    };
+
+    template <class U, class A>
+    struct serializer<std::vector<U, A>>
+        : std::conditional_t<
+              details::is_contiguous_trivial<std::vector<U, A>>::value,
+              details::contiguous_serializer<std::vector<U, A>>,
+              std::conditional_t<
+                  details::is_contiguous_trivial<U>::value,
+                  details::ragged_serializer<std::vector<U, A>>,
+                  details::sequence_serializer<std::vector<U, A>>>>
+    {
+    };
+
+    template <class F, class S>
+    struct serializer<std::pair<F, S>, std::enable_if_t<!std::is_trivially_copyable<std::pair<F, S>>::value>>
+    {
+        static std::size_t size(std::pair<F, S> const &value)
+        {
+            return serializer<F>::size(value.first) + serializer<S>::size(value.second);
+        }
+        static void write(std::pair<F, S> const &value, char *&out)
+        {
+            serializer<F>::write(value.first, out);
+            serializer<S>::write(value.second, out);
+        }
+        static void read(char const *&in, char const *end, std::pair<F, S> &value)
+        {
+            serializer<F>::read(in, end, value.first);
+            serializer<S>::read(in, end, value.second);
+        }
+    };
+
+    template <class K, class V, class C, class A>
+    struct serializer<std::map<K, V, C, A>> : details::map_serializer<std::map<K, V, C, A>>
+    {
+    };
+
+    template <class K, class V, class H, class E, class A>
+    struct serializer<std::unordered_map<K, V, H, E, A>> : details::map_serializer<std::unordered_map<K, V, H, E, A>>
+    {
+    };
+
+    // Encodes value into buffer, which is resized to exactly the encoded
+    // length in one allocation.
+    template <class T>
+    void pack(T const &value, std::vector<char> &buffer)
+    {
+        buffer.resize(serializer<T>::size(value));
+        char *out = buffer.data();
+        serializer<T>::write(value, out);
+    }
+
+    template <class T>
+    std::vector<char> pack(T const &value)
+    {
+        std::vector<char> buffer;
+        pack(value, buffer);
+        return buffer;
+    }
+
+    template <class T>
+    void unpack(char const *data, std::size_t size, T &value)
+    {
+        char const *in = data;
+        serializer<T>::read(in, data + size, value);
+    }
+
+    template <class T>
+    void unpack(std::vector<char> const &buffer, T &value)
+    {
+        unpack(buffer.data(), buffer.size(), value);
+    }
+
+    template <class U>
+    class array_view
+    {
+        U const *first;
+        std::size_t count;
+
+    public:
+        constexpr array_view(U const *first_arg, std::size_t count_arg)
+            : first(first_arg), count(count_arg)
+        {
+        }
+        constexpr U const *data() const { return first; }
+        constexpr std::size_t size() const { return count; }
+        constexpr bool empty() const { return count == 0; }
+        constexpr U const *begin() const { return first; }
+        constexpr U const *end() const { return first + count; }
+        constexpr U const &operator[](std::size_t i) const { return first[i]; }
+        template <class C = U, class = std::enable_if_t<std::is_same<C, char>::value>>
+        std::string_view str() const
+        {
+            return std::string_view(first, count);
+        }
+    };
+
+    // Reads a packed std::vector<std::vector<U>> or std::vector<std::string>
+    // in place, without rebuilding the inner containers. The buffer must
+    // start at the packed value (as returned by pack or received whole) and
+    // outlive the view.
+    template <class U>
+    class ragged_view
+    {
+        std::size_t count;
+        char const *offsets;
+        char const *payload;
+
+        std::uint64_t offset(std::size_t i) const
+        {
+            std::uint64_t result;
+            std::memcpy(&result, offsets + sizeof(std::uint64_t) * i, sizeof(result));
+            return result;
+        }
+
+    public:
+        ragged_view(char const *data, std::size_t size)
+        {
+            char const *in = data;
+            char const *end = data + size;
+            std::uint64_t length = details::read_length(in, end);
+            if (std::uint64_t(end - in) / sizeof(std::uint64_t) <= length)
+            {
+                throw exception("mpicxx: truncated serialized buffer");
+            }
+            count = std::size_t(length);
+            offsets = in;
+            payload = in + sizeof(std::uint64_t) * (length + 1);
+            if (std::uint64_t(end - payload) < offset(count))
+            {
+                throw exception("mpicxx: truncated serialized buffer");
+            }
+        }
+        explicit ragged_view(std::vector<char> const &buffer)
+            : ragged_view(buffer.data(), buffer.size())
+        {
+        }
+        std::size_t size() const { return count; }
+        array_view<U> operator[](std::size_t i) const
+        {
+            std::uint64_t first = offset(i);
+            return array_view<U>(
+                reinterpret_cast<U const *>(payload + first),
+                std::size_t((offset(i + 1) - first) / sizeof(U)));
+        }
+    };
+
+    // Reads a packed std::vector<U> of trivially copyable U in place.
+    template <class U>
+    array_view<U> packed_array_view(std::vector<char> const &buffer)
+    {
+        char const *in = buffer.data();
+        char const *end = in + buffer.size();
+        std::uint64_t length = details::read_length(in, end);
+        if (std::uint64_t(end - in) / sizeof(U) < length)
+        {
+            throw exception("mpicxx: truncated serialized buffer");
+        }
+        return array_view<U>(reinterpret_cast<U const *>(in), std::size_t(length));
+    }
+}
+
+// Makes serializer<type> encode the listed members in order, e.g.
+//   MPICXX_SERIALIZE_MEMBERS(record, &record::name, &record::values)
+// The type must be default constructible and not trivially copyable (those
+// are already copied bytewise). Use at global namespace scope.
+#define MPICXX_SERIALIZE_MEMBERS(type, ...)                                      \
+    template <>                                                                  \
+    struct mpicxx::serializer<type>                                              \
+        : mpicxx::details::member_serializer<type, __VA_ARGS__>                  \
+    {                                                                            \
+    };
+
+#endif
@@ -1,108 +1,2181 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "error/exception.hpp"
 #include "handles/request.hpp"
+#include "handles/completion_queue.hpp"
 #include "datatype/datatype.hpp"
 #include "communicators/comm.hpp"
+#include "instrumentation/instrumentation.hpp"
+
+namespace mpicxx
+{
+    namespace
+    {
+        bool fits_int(std::size_t count)
+        {
+            return count <= std::size_t(std::numeric_limits<int>::max());
+        }
+
+        // Completes the chunks of a split operation one after another; all of
+        // them were started up front and progress concurrently.
+        class chunk_continuation : public details::request_continuation
+        {
+            std::vector<MPI_Request> remaining;
+            std::size_t next = 0;
+
+        public:
+            explicit chunk_continuation(std::vector<MPI_Request> remaining_arg)
+                : remaining(std::move(remaining_arg))
+            {
+            }
+            bool complete(MPI_Request &implementation) override
+            {
+                if (next == remaining.size())
+                {
+                    return true;
+                }
+                implementation = remaining[next++];
+                return false;
+            }
+        };
+
+        void check_per_rank(std::vector<std::size_t> const &counts, std::vector<std::size_t> const &displs, int ranks)
+        {
+            if (counts.size() != std::size_t(ranks) || displs.size() != std::size_t(ranks))
+            {
+                throw exception("mpicxx: v-collectives need one count and one displacement per rank");
+            }
+        }
+
+#if MPI_VERSION >= 4
+        // Keeps the count and displacement arrays of a large-count
+        // v-collective alive until it completes.
+        class count_arrays_continuation : public details::request_continuation
+        {
+        public:
+            std::vector<MPI_Count> send_counts;
+            std::vector<MPI_Aint> send_displs;
+            std::vector<MPI_Count> recv_counts;
+            std::vector<MPI_Aint> recv_displs;
+
+            bool complete(MPI_Request &) override
+            {
+                return true;
+            }
+        };
+#else
+        MPI_Aint extent_of(datatype const &datatype_arg)
+        {
+            MPI_Aint lb;
+            MPI_Aint extent;
+            handle_error(MPI_Type_get_extent(datatype_arg.get(), &lb, &extent));
+            return extent;
+        }
+
+        // buf advanced by byte_offset; MPI_IN_PLACE and null buffers (ignored
+        // arguments) are passed through.
+        void const *advance(void const *buf, MPI_Aint byte_offset)
+        {
+            if (buf == MPI_IN_PLACE || buf == nullptr)
+            {
+                return buf;
+            }
+            return static_cast<char const *>(buf) + byte_offset;
+        }
+
+        void *advance(void *buf, MPI_Aint byte_offset)
+        {
+            if (buf == MPI_IN_PLACE || buf == nullptr)
+            {
+                return buf;
+            }
+            return static_cast<char *>(buf) + byte_offset;
+        }
+
+        // One request for operations started up front.
+        request join_requests(std::vector<MPI_Request> requests)
+        {
+            if (requests.empty())
+            {
+                return request();
+            }
+            MPI_Request first = requests.front();
+            requests.erase(requests.begin());
+            return request(
+                first,
+                std::unique_ptr<details::request_continuation>(new chunk_continuation(std::move(requests))));
+        }
+
+        // Reduction operations only apply to their element type, so large
+        // reductions are split into INT_MAX-element chunks reduced
+        // concurrently. start_chunk gets the byte offset and element count.
+        request start_chunked(
+            std::size_t count,
+            datatype const &datatype_arg,
+            std::function<MPI_Request(MPI_Aint, int)> const &start_chunk)
+        {
+            MPI_Aint extent = extent_of(datatype_arg);
+            std::size_t const chunk = std::size_t(std::numeric_limits<int>::max());
+            std::vector<MPI_Request> chunks;
+            for (std::size_t offset = 0; offset < count; offset += chunk)
+            {
+                std::size_t chunk_count = count - offset < chunk ? count - offset : chunk;
+                chunks.push_back(start_chunk(MPI_Aint(offset) * extent, int(chunk_count)));
+            }
+            return join_requests(std::move(chunks));
+        }
+
+        // count elements as a single element whose extent is theirs, so
+        // per-rank blocks of alltoall and allgather stay count elements apart.
+        datatype large_block_datatype(std::size_t count, datatype const &datatype_arg)
+        {
+            datatype result = datatype::create_resized(
+                details::large_count_datatype(count, datatype_arg),
+                0,
+                MPI_Aint(count) * extent_of(datatype_arg));
+            result.commit();
+            return result;
+        }
+#endif
+
+        // Owned duplicate of a datatype for operations that outlive the call
+        // that started them. Predefined types are never freed and are kept
+        // as they are, since predefined reduction ops reject duplicates.
+        datatype duplicate_datatype(datatype const &datatype_arg)
+        {
+            int integers;
+            int addresses;
+            int datatypes;
+            int combiner;
+            handle_error(
+                MPI_Type_get_envelope(
+                    datatype_arg.get(),
+                    &integers,
+                    &addresses,
+                    &datatypes,
+                    &combiner));
+            if (combiner == MPI_COMBINER_NAMED)
+            {
+                return datatype(datatype_arg.get(), false);
+            }
+            MPI_Datatype duplicate;
+            handle_error(MPI_Type_dup(datatype_arg.get(), &duplicate));
+            return datatype(duplicate, true);
+        }
+
+        // Runs a collective as a sequence of segments, keeping up to depth of
+        // them in flight. The segments run on a communicator of their own,
+        // duplicated from the parent by the first request, so they cannot
+        // be matched against another operation's, whatever order the
+        // requests are completed in. The request then holds the oldest
+        // segment; when it completes the next segment is started before the
+        // callback for the completed one runs. start_segment uses
+        // element_type, reduction and segments, which live as long as the
+        // request.
+        class segmented_continuation : public details::request_continuation
+        {
+        public:
+            datatype element_type;
+            op reduction;
+            MPI_Comm segments = MPI_COMM_NULL;
+            std::function<MPI_Request(std::size_t, std::size_t)> start_segment;
+            std::function<void(std::size_t, std::size_t)> on_segment;
+            std::size_t count = 0;
+            std::size_t segment = 0;
+            int depth = 0;
+            std::size_t started = 0;
+            std::size_t finished = 0;
+            bool duplicated = false;
+            std::deque<MPI_Request> in_flight;
+
+            ~segmented_continuation() override
+            {
+                if (duplicated)
+                {
+                    MPI_Comm_free(&segments);
+                }
+            }
+
+            MPI_Request start_next()
+            {
+                std::size_t length = std::min(segment, count - started);
+                MPI_Request result = start_segment(started, length);
+                started += length;
+                return result;
+            }
+
+            bool complete(MPI_Request &implementation) override
+            {
+                if (!duplicated)
+                {
+                    duplicated = true;
+                    implementation = start_next();
+                    for (int i = 1; i < depth && started < count; ++i)
+                    {
+                        in_flight.push_back(start_next());
+                    }
+                    return false;
+                }
+                if (started < count)
+                {
+                    in_flight.push_back(start_next());
+                }
+                if (!in_flight.empty())
+                {
+                    implementation = in_flight.front();
+                    in_flight.pop_front();
+                }
+                std::size_t offset = finished;
+                std::size_t length = std::min(segment, count - finished);
+                finished += length;
+                if (on_segment)
+                {
+                    on_segment(offset, length);
+                }
+                return finished == count;
+            }
+        };
+
+        // Duplicates parent for the segments; the continuation starts the
+        // first depth of them once that completes, and the rest as they go.
+        request start_segmented(
+            MPI_Comm parent,
+            std::unique_ptr<segmented_continuation> continuation,
+            std::size_t count,
+            std::size_t segment,
+            int depth)
+        {
+            if (segment == 0 || depth < 1)
+            {
+                throw exception("mpicxx: pipelined collectives need a nonzero segment size and depth");
+            }
+            details::checked_count(segment);
+            continuation->count = count;
+            continuation->segment = segment;
+            continuation->depth = depth;
+            if (count == 0)
+            {
+                return request();
+            }
+            MPI_Request duplicate;
+            handle_error(
+                MPI_Comm_idup(
+                    parent,
+                    &continuation->segments,
+                    &duplicate));
+            return request(
+                duplicate,
+                std::unique_ptr<details::request_continuation>(continuation.release()));
+        }
+
+        struct any_size_header
+        {
+            std::uint64_t count;
+            unsigned char payload[comm::eager_bcast_bytes];
+        };
+
+        int delete_phase_comm(MPI_Comm, int, void *attribute_val, void *)
+        {
+            MPI_Comm *phase = static_cast<MPI_Comm *>(attribute_val);
+            int result = MPI_Comm_free(phase);
+            delete phase;
+            return result;
+        }
+
+        int phase_comm_keyval()
+        {
+            static int const keyval = []
+            {
+                int created;
+                handle_error(
+                    MPI_Comm_create_keyval(
+                        MPI_COMM_NULL_COPY_FN,
+                        delete_phase_comm,
+                        &created,
+                        nullptr));
+                return created;
+            }();
+            return keyval;
+        }
+
+        // Private duplicate of parent for the second phase of multi-phase
+        // collectives, cached as an attribute so it is freed with parent.
+        MPI_Comm phase_comm(MPI_Comm parent)
+        {
+            MPI_Comm *cached;
+            int found;
+            handle_error(
+                MPI_Comm_get_attr(
+                    parent,
+                    phase_comm_keyval(),
+                    &cached,
+                    &found));
+            if (found)
+            {
+                return *cached;
+            }
+            std::unique_ptr<MPI_Comm> duplicate(new MPI_Comm);
+            handle_error(MPI_Comm_dup(parent, duplicate.get()));
+            handle_error(
+                MPI_Comm_set_attr(
+                    parent,
+                    phase_comm_keyval(),
+                    duplicate.get()));
+            return *duplicate.release();
+        }
+
+        bool fits_eager_header(std::size_t count, MPI_Datatype datatype_arg)
+        {
+            int size;
+            MPI_Aint lb, extent;
+            handle_error(MPI_Type_size(datatype_arg, &size));
+            handle_error(MPI_Type_get_extent(datatype_arg, &lb, &extent));
+            return lb == 0 && extent == size && count <= comm::eager_bcast_bytes / std::size_t(size);
+        }
+
+        // Every rank, root included, starts the second phase for large
+        // payloads from the wait or test that completes the header, so the
+        // phase communicator sees the same sequence of broadcasts on all of
+        // them. Non-roots size their buffer from the header first; done runs
+        // on them once the payload is in place.
+        class any_size_bcast_continuation : public details::request_continuation
+        {
+        public:
+            any_size_header header;
+            std::function<void *(std::size_t)> resize;
+            std::function<void()> done;
+            // Owned, as the second phase starts after ibcast_any_size returns.
+            datatype element_type;
+            MPI_Comm phase;
+            int root;
+            bool is_root;
+            void *root_buffer = nullptr;
+            bool header_done = false;
+
+            bool finish()
+            {
+                if (done)
+                {
+                    done();
+                }
+                return true;
+            }
+
+            bool complete(MPI_Request &implementation) override
+            {
+                if (header_done)
+                {
+                    return finish();
+                }
+                header_done = true;
+                std::size_t count = std::size_t(header.count);
+                void *buf = is_root ? root_buffer : resize(count);
+                if (fits_eager_header(count, element_type.get()))
+                {
+                    if (is_root)
+                    {
+                        return true;
+                    }
+                    int size;
+                    handle_error(MPI_Type_size(element_type.get(), &size));
+                    if (count != 0)
+                    {
+                        std::memcpy(buf, header.payload, count * std::size_t(size));
+                    }
+                    return finish();
+                }
+                implementation = comm(phase, false).ibcast(
+                    buf,
+                    count,
+                    element_type,
+                    root).release();
+                return false;
+            }
+        };
+
+        // Owns the buffer a packed message is received into and hands it to
+        // done once the receive completes.
+        class packed_recv_continuation : public details::request_continuation
+        {
+        public:
+            std::vector<char> packed;
+            std::function<void(std::vector<char> const &)> done;
+
+            bool complete(MPI_Request &) override
+            {
+                done(packed);
+                return true;
+            }
+        };
+
+        // Gathers the byte counts to root first. Every rank starts the byte
+        // gatherv on the phase communicator from the wait or test that
+        // completes that step, root after sizing the result from the counts.
+        class packed_gather_continuation : public details::request_continuation
+        {
+        public:
+            std::vector<char> packed;
+            int packed_size;
+            std::vector<int> sizes;
+            std::vector<int> displacements;
+            std::vector<char> gathered;
+            std::function<void(std::vector<char> const &, std::vector<std::size_t> const &)> done;
+            MPI_Comm phase;
+            int root;
+            bool is_root;
+            bool sizes_done = false;
+
+            bool complete(MPI_Request &implementation) override
+            {
+                if (sizes_done)
+                {
+                    if (done)
+                    {
+                        std::vector<std::size_t> offsets(sizes.size() + 1, 0);
+                        for (std::size_t i = 0; i < sizes.size(); ++i)
+                        {
+                            offsets[i + 1] = offsets[i] + std::size_t(sizes[i]);
+                        }
+                        done(gathered, offsets);
+                    }
+                    return true;
+                }
+                sizes_done = true;
+                if (!is_root)
+                {
+                    handle_error(
+                        MPI_Igatherv(
+                            packed.data(),
+                            packed_size,
+                            MPI_BYTE,
+                            nullptr,
+                            nullptr,
+                            nullptr,
+                            MPI_BYTE,
+                            root,
+                            phase,
+                            &implementation));
+                    return false;
+                }
+                displacements.resize(sizes.size());
+                std::size_t total = 0;
+                for (std::size_t i = 0; i < sizes.size(); ++i)
+                {
+                    displacements[i] = details::checked_count(total);
+                    total += std::size_t(sizes[i]);
+                }
+                details::checked_count(total);
+                gathered.resize(total);
+                handle_error(
+                    MPI_Igatherv(
+                        packed.data(),
+                        packed_size,
+                        MPI_BYTE,
+                        gathered.data(),
+                        sizes.data(),
+                        displacements.data(),
+                        MPI_BYTE,
+                        root,
+                        phase,
+                        &implementation));
+                return false;
+            }
+        };
+    }
+
+    namespace details
+    {
+        int checked_count(std::size_t count)
+        {
+            if (!fits_int(count))
+            {
+                throw exception("mpicxx: element count exceeds INT_MAX for an operation without large-count support");
+            }
+            return int(count);
+        }
+    }
+
+
+    comm &comm::operator=(comm &&other)
+    {
+        if (owned && implementation != MPI_COMM_NULL)
+        {
+            handle_error(MPI_Comm_free(&implementation));
+        }
+        implementation = other.implementation;
+        owned = other.owned;
+        other.implementation = MPI_COMM_NULL;
+        other.owned = false;
+        return *this;
+    }
+
+    comm::~comm()
+    {
+        if (owned && implementation != MPI_COMM_NULL)
+        {
+            handle_error(MPI_Comm_free(&implementation));
+        }
+    }
+
+    int comm::size() const
+    {
+        int result_size;
+        handle_error(
+            MPI_Comm_size(
+                implementation,
+                &result_size));
+        return result_size;
+    }
+
+    int comm::rank() const
+    {
+        int result_rank;
+        handle_error(
+            MPI_Comm_rank(
+                implementation,
+                &result_rank));
+        return result_rank;
+    }
+
+    void comm::set_name(std::string const &name_arg)
+    {
+        handle_error(
+            MPI_Comm_set_name(
+                implementation,
+                name_arg.c_str()));
+    }
+
+    std::string comm::name() const
+    {
+        char result_name[MPI_MAX_OBJECT_NAME];
+        int length;
+        handle_error(
+            MPI_Comm_get_name(
+                implementation,
+                result_name,
+                &length));
+        return std::string(result_name, std::size_t(length));
+    }
+
+    request comm::iallreduce(
+        void const *sendbuf,
+        void *recvbuf,
+        int count,
+        datatype const &datatype_arg,
+        op const &op_arg) const
+    {
+        MPICXX_INSTRUMENT("iallreduce", implementation, std::size_t(count), datatype_arg.get());
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Iallreduce(
+                sendbuf,
+                recvbuf,
+                count,
+                datatype_arg.get(),
+                op_arg.get(),
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+    }
+
+    request comm::isend(
+        void const *buf,
+        int count,
+        datatype datatype_arg,
+        int dest,
+        int tag) const
+    {
+        MPICXX_INSTRUMENT("isend", implementation, std::size_t(count), datatype_arg.get());
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Isend(
+                buf,
+                count,
+                datatype_arg.get(),
+                dest,
+                tag,
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+    }
+
+    request comm::irecv(
+        void *buf,
+        int count,
+        datatype datatype_arg,
+        int dest,
+        int tag) const
+    {
+        MPICXX_INSTRUMENT("irecv", implementation, std::size_t(count), datatype_arg.get());
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Irecv(
+                buf,
+                count,
+                datatype_arg.get(),
+                dest,
+                tag,
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+    }
+
+    persistent_request comm::send_init(
+        void const *buf,
+        int count,
+        datatype const &datatype_arg,
+        int dest,
+        int tag) const
+    {
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Send_init(
+                buf,
+                count,
+                datatype_arg.get(),
+                dest,
+                tag,
+                implementation,
+                &request_implementation));
+        return persistent_request(request_implementation);
+    }
+
+    persistent_request comm::recv_init(
+        void *buf,
+        int count,
+        datatype const &datatype_arg,
+        int source,
+        int tag) const
+    {
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Recv_init(
+                buf,
+                count,
+                datatype_arg.get(),
+                source,
+                tag,
+                implementation,
+                &request_implementation));
+        return persistent_request(request_implementation);
+    }
+
+#if MPI_VERSION >= 4
+    persistent_request comm::allreduce_init(
+        void const *sendbuf,
+        void *recvbuf,
+        int count,
+        datatype const &datatype_arg,
+        op const &op_arg,
+        MPI_Info info) const
+    {
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Allreduce_init(
+                sendbuf,
+                recvbuf,
+                count,
+                datatype_arg.get(),
+                op_arg.get(),
+                implementation,
+                info,
+                &request_implementation));
+        return persistent_request(request_implementation);
+    }
+
+    persistent_request comm::bcast_init(
+        void *buf,
+        int count,
+        datatype const &datatype_arg,
+        int root,
+        MPI_Info info) const
+    {
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Bcast_init(
+                buf,
+                count,
+                datatype_arg.get(),
+                root,
+                implementation,
+                info,
+                &request_implementation));
+        return persistent_request(request_implementation);
+    }
+#endif
+
+    request comm::ialltoall(
+        void const *sendbuf,
+        void *recvbuf,
+        int count,
+        datatype const &datatype_arg) const
+    {
+        MPICXX_INSTRUMENT("ialltoall", implementation, std::size_t(count) * std::size_t(size()), datatype_arg.get());
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Ialltoall(
+                sendbuf,
+                count,
+                datatype_arg.get(),
+                recvbuf,
+                count,
+                datatype_arg.get(),
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+    }
+
+    request comm::ialltoallv(
+        void const *sendbuf,
+        int const send_counts[],
+        int const send_displs[],
+        void *recvbuf,
+        int const recv_counts[],
+        int const recv_displs[],
+        datatype const &datatype_arg) const
+    {
+        MPICXX_INSTRUMENT("ialltoallv", implementation, details::instrumentation::total(sendbuf == MPI_IN_PLACE ? recv_counts : send_counts, size()), datatype_arg.get());
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Ialltoallv(
+                sendbuf,
+                send_counts,
+                send_displs,
+                datatype_arg.get(),
+                recvbuf,
+                recv_counts,
+                recv_displs,
+                datatype_arg.get(),
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+    }
+
+    request comm::ialltoallw(
+        void const *sendbuf,
+        std::vector<int> const &send_counts,
+        std::vector<int> const &send_displs,
+        std::vector<MPI_Datatype> const &send_types,
+        void *recvbuf,
+        std::vector<int> const &recv_counts,
+        std::vector<int> const &recv_displs,
+        std::vector<MPI_Datatype> const &recv_types) const
+    {
+        MPICXX_INSTRUMENT("ialltoallw", implementation, 0, MPI_BYTE);
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Ialltoallw(
+                sendbuf,
+                send_counts.data(),
+                send_displs.data(),
+                send_types.data(),
+                recvbuf,
+                recv_counts.data(),
+                recv_displs.data(),
+                recv_types.data(),
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+    }
+
+    request comm::iallgather(
+        void const *sendbuf,
+        void *recvbuf,
+        int count,
+        datatype const &datatype_arg) const
+    {
+        MPICXX_INSTRUMENT("iallgather", implementation, std::size_t(count), datatype_arg.get());
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Iallgather(
+                sendbuf,
+                count,
+                datatype_arg.get(),
+                recvbuf,
+                count,
+                datatype_arg.get(),
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+    }
+
+    request comm::iallgatherv(
+        void const *sendbuf,
+        int send_count,
+        void *recvbuf,
+        int const recv_counts[],
+        int const recv_displs[],
+        datatype const &datatype_arg) const
+    {
+        MPICXX_INSTRUMENT("iallgatherv", implementation, std::size_t(send_count), datatype_arg.get());
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Iallgatherv(
+                sendbuf,
+                send_count,
+                datatype_arg.get(),
+                recvbuf,
+                recv_counts,
+                recv_displs,
+                datatype_arg.get(),
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+    }
+
+    request comm::ireduce(
+        void const *sendbuf,
+        void *recvbuf,
+        int count,
+        datatype const &datatype_arg,
+        op const &op_arg,
+        int root) const
+    {
+        MPICXX_INSTRUMENT("ireduce", implementation, std::size_t(count), datatype_arg.get());
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Ireduce(
+                sendbuf,
+                recvbuf,
+                count,
+                datatype_arg.get(),
+                op_arg.get(),
+                root,
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+    }
+
+    request comm::ireduce_scatter(
+        void const *sendbuf,
+        void *recvbuf,
+        int const recv_counts[],
+        datatype const &datatype_arg,
+        op const &op_arg) const
+    {
+        MPICXX_INSTRUMENT("ireduce_scatter", implementation, details::instrumentation::total(recv_counts, size()), datatype_arg.get());
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Ireduce_scatter(
+                sendbuf,
+                recvbuf,
+                recv_counts,
+                datatype_arg.get(),
+                op_arg.get(),
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+    }
+
+    request comm::ireduce_scatter_block(
+        void const *sendbuf,
+        void *recvbuf,
+        int recv_count,
+        datatype const &datatype_arg,
+        op const &op_arg) const
+    {
+        MPICXX_INSTRUMENT("ireduce_scatter_block", implementation, std::size_t(recv_count) * std::size_t(size()), datatype_arg.get());
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Ireduce_scatter_block(
+                sendbuf,
+                recvbuf,
+                recv_count,
+                datatype_arg.get(),
+                op_arg.get(),
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+    }
+
+    request comm::iscan(
+        void const *sendbuf,
+        void *recvbuf,
+        int count,
+        datatype const &datatype_arg,
+        op const &op_arg) const
+    {
+        MPICXX_INSTRUMENT("iscan", implementation, std::size_t(count), datatype_arg.get());
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Iscan(
+                sendbuf,
+                recvbuf,
+                count,
+                datatype_arg.get(),
+                op_arg.get(),
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+    }
+
+    request comm::iexscan(
+        void const *sendbuf,
+        void *recvbuf,
+        int count,
+        datatype const &datatype_arg,
+        op const &op_arg) const
+    {
+        MPICXX_INSTRUMENT("iexscan", implementation, std::size_t(count), datatype_arg.get());
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Iexscan(
+                sendbuf,
+                recvbuf,
+                count,
+                datatype_arg.get(),
+                op_arg.get(),
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+    }
+
+    request comm::ineighbor_alltoallw(
+        void const *sendbuf,
+        std::vector<int> const &send_counts,
+        std::vector<MPI_Aint> const &send_disp,
+        std::vector<MPI_Datatype> const &send_types,
+        void *recvbuf,
+        std::vector<int> const &recv_counts,
+        std::vector<MPI_Aint> const &recv_disp,
+        std::vector<MPI_Datatype> const &recv_types) const
+    {
+        MPICXX_INSTRUMENT("ineighbor_alltoallw", implementation, 0, MPI_BYTE);
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Ineighbor_alltoallw(
+                sendbuf,
+                send_counts.data(),
+                send_disp.data(),
+                send_types.data(),
+                recvbuf,
+                recv_counts.data(),
+                recv_disp.data(),
+                recv_types.data(),
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+    }
+
+    request comm::isend_count(
+        void const *buf,
+        std::size_t count,
+        datatype const &datatype_arg,
+        int dest,
+        int tag) const
+    {
+        MPICXX_INSTRUMENT("isend", implementation, count, datatype_arg.get());
+        MPI_Request request_implementation;
+        if (fits_int(count))
+        {
+            handle_error(
+                MPI_Isend(
+                    buf,
+                    int(count),
+                    datatype_arg.get(),
+                    dest,
+                    tag,
+                    implementation,
+                    &request_implementation));
+            return request(request_implementation);
+        }
+#if MPI_VERSION >= 4
+        handle_error(
+            MPI_Isend_c(
+                buf,
+                MPI_Count(count),
+                datatype_arg.get(),
+                dest,
+                tag,
+                implementation,
+                &request_implementation));
+#else
+        datatype large_type = details::large_count_datatype(count, datatype_arg);
+        handle_error(
+            MPI_Isend(
+                buf,
+                1,
+                large_type.get(),
+                dest,
+                tag,
+                implementation,
+                &request_implementation));
+#endif
+        return request(request_implementation);
+    }
+
+    request comm::irecv_count(
+        void *buf,
+        std::size_t count,
+        datatype const &datatype_arg,
+        int source,
+        int tag) const
+    {
+        MPICXX_INSTRUMENT("irecv", implementation, count, datatype_arg.get());
+        MPI_Request request_implementation;
+        if (fits_int(count))
+        {
+            handle_error(
+                MPI_Irecv(
+                    buf,
+                    int(count),
+                    datatype_arg.get(),
+                    source,
+                    tag,
+                    implementation,
+                    &request_implementation));
+            return request(request_implementation);
+        }
+#if MPI_VERSION >= 4
+        handle_error(
+            MPI_Irecv_c(
+                buf,
+                MPI_Count(count),
+                datatype_arg.get(),
+                source,
+                tag,
+                implementation,
+                &request_implementation));
+#else
+        datatype large_type = details::large_count_datatype(count, datatype_arg);
+        handle_error(
+            MPI_Irecv(
+                buf,
+                1,
+                large_type.get(),
+                source,
+                tag,
+                implementation,
+                &request_implementation));
+#endif
+        return request(request_implementation);
+    }
+
+    request comm::iallreduce_count(
+        void const *sendbuf,
+        void *recvbuf,
+        std::size_t count,
+        datatype const &datatype_arg,
+        op const &op_arg) const
+    {
+        MPICXX_INSTRUMENT("iallreduce", implementation, count, datatype_arg.get());
+        MPI_Request request_implementation;
+        if (fits_int(count))
+        {
+            handle_error(
+                MPI_Iallreduce(
+                    sendbuf,
+                    recvbuf,
+                    int(count),
+                    datatype_arg.get(),
+                    op_arg.get(),
+                    implementation,
+                    &request_implementation));
+            return request(request_implementation);
+        }
+#if MPI_VERSION >= 4
+        handle_error(
+            MPI_Iallreduce_c(
+                sendbuf,
+                recvbuf,
+                MPI_Count(count),
+                datatype_arg.get(),
+                op_arg.get(),
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+#else
+        return start_chunked(
+            count,
+            datatype_arg,
+            [&](MPI_Aint byte_offset, int chunk_count)
+            {
+                MPI_Request chunk_implementation;
+                handle_error(
+                    MPI_Iallreduce(
+                        advance(sendbuf, byte_offset),
+                        advance(recvbuf, byte_offset),
+                        chunk_count,
+                        datatype_arg.get(),
+                        op_arg.get(),
+                        implementation,
+                        &chunk_implementation));
+                return chunk_implementation;
+            });
+#endif
+    }
+
+    request comm::ialltoall_count(
+        void const *sendbuf,
+        void *recvbuf,
+        std::size_t count,
+        datatype const &datatype_arg) const
+    {
+        if (fits_int(count))
+        {
+            return ialltoall(sendbuf, recvbuf, int(count), datatype_arg);
+        }
+        MPICXX_INSTRUMENT("ialltoall", implementation, count * std::size_t(size()), datatype_arg.get());
+        MPI_Request request_implementation;
+#if MPI_VERSION >= 4
+        handle_error(
+            MPI_Ialltoall_c(
+                sendbuf,
+                MPI_Count(count),
+                datatype_arg.get(),
+                recvbuf,
+                MPI_Count(count),
+                datatype_arg.get(),
+                implementation,
+                &request_implementation));
+#else
+        datatype block = large_block_datatype(count, datatype_arg);
+        handle_error(
+            MPI_Ialltoall(
+                sendbuf,
+                1,
+                block.get(),
+                recvbuf,
+                1,
+                block.get(),
+                implementation,
+                &request_implementation));
+#endif
+        return request(request_implementation);
+    }
+
+    request comm::iallgather_count(
+        void const *sendbuf,
+        void *recvbuf,
+        std::size_t count,
+        datatype const &datatype_arg) const
+    {
+        if (fits_int(count))
+        {
+            return iallgather(sendbuf, recvbuf, int(count), datatype_arg);
+        }
+        MPICXX_INSTRUMENT("iallgather", implementation, count, datatype_arg.get());
+        MPI_Request request_implementation;
+#if MPI_VERSION >= 4
+        handle_error(
+            MPI_Iallgather_c(
+                sendbuf,
+                MPI_Count(count),
+                datatype_arg.get(),
+                recvbuf,
+                MPI_Count(count),
+                datatype_arg.get(),
+                implementation,
+                &request_implementation));
+#else
+        datatype block = large_block_datatype(count, datatype_arg);
+        handle_error(
+            MPI_Iallgather(
+                sendbuf,
+                1,
+                block.get(),
+                recvbuf,
+                1,
+                block.get(),
+                implementation,
+                &request_implementation));
+#endif
+        return request(request_implementation);
+    }
+
+    request comm::ireduce_count(
+        void const *sendbuf,
+        void *recvbuf,
+        std::size_t count,
+        datatype const &datatype_arg,
+        op const &op_arg,
+        int root) const
+    {
+        if (fits_int(count))
+        {
+            return ireduce(sendbuf, recvbuf, int(count), datatype_arg, op_arg, root);
+        }
+        MPICXX_INSTRUMENT("ireduce", implementation, count, datatype_arg.get());
+#if MPI_VERSION >= 4
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Ireduce_c(
+                sendbuf,
+                recvbuf,
+                MPI_Count(count),
+                datatype_arg.get(),
+                op_arg.get(),
+                root,
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+#else
+        return start_chunked(
+            count,
+            datatype_arg,
+            [&](MPI_Aint byte_offset, int chunk_count)
+            {
+                MPI_Request chunk_implementation;
+                handle_error(
+                    MPI_Ireduce(
+                        advance(sendbuf, byte_offset),
+                        advance(recvbuf, byte_offset),
+                        chunk_count,
+                        datatype_arg.get(),
+                        op_arg.get(),
+                        root,
+                        implementation,
+                        &chunk_implementation));
+                return chunk_implementation;
+            });
+#endif
+    }
+
+    request comm::iscan_count(
+        void const *sendbuf,
+        void *recvbuf,
+        std::size_t count,
+        datatype const &datatype_arg,
+        op const &op_arg) const
+    {
+        if (fits_int(count))
+        {
+            return iscan(sendbuf, recvbuf, int(count), datatype_arg, op_arg);
+        }
+        MPICXX_INSTRUMENT("iscan", implementation, count, datatype_arg.get());
+#if MPI_VERSION >= 4
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Iscan_c(
+                sendbuf,
+                recvbuf,
+                MPI_Count(count),
+                datatype_arg.get(),
+                op_arg.get(),
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+#else
+        return start_chunked(
+            count,
+            datatype_arg,
+            [&](MPI_Aint byte_offset, int chunk_count)
+            {
+                MPI_Request chunk_implementation;
+                handle_error(
+                    MPI_Iscan(
+                        advance(sendbuf, byte_offset),
+                        advance(recvbuf, byte_offset),
+                        chunk_count,
+                        datatype_arg.get(),
+                        op_arg.get(),
+                        implementation,
+                        &chunk_implementation));
+                return chunk_implementation;
+            });
+#endif
+    }
+
+    request comm::iexscan_count(
+        void const *sendbuf,
+        void *recvbuf,
+        std::size_t count,
+        datatype const &datatype_arg,
+        op const &op_arg) const
+    {
+        if (fits_int(count))
+        {
+            return iexscan(sendbuf, recvbuf, int(count), datatype_arg, op_arg);
+        }
+        MPICXX_INSTRUMENT("iexscan", implementation, count, datatype_arg.get());
+#if MPI_VERSION >= 4
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Iexscan_c(
+                sendbuf,
+                recvbuf,
+                MPI_Count(count),
+                datatype_arg.get(),
+                op_arg.get(),
+                implementation,
+                &request_implementation));
+        return request(request_implementation);
+#else
+        return start_chunked(
+            count,
+            datatype_arg,
+            [&](MPI_Aint byte_offset, int chunk_count)
+            {
+                MPI_Request chunk_implementation;
+                handle_error(
+                    MPI_Iexscan(
+                        advance(sendbuf, byte_offset),
+                        advance(recvbuf, byte_offset),
+                        chunk_count,
+                        datatype_arg.get(),
+                        op_arg.get(),
+                        implementation,
+                        &chunk_implementation));
+                return chunk_implementation;
+            });
+#endif
+    }
+
+    // Without MPI-4 the large-count v-collectives below are carried out as
+    // point-to-point messages on the phase communicator. Every rank starts
+    // its transfers in the same collective order and zero-count transfers
+    // are skipped on both sides, so messages match in order.
+    request comm::igatherv_count(
+        void const *sendbuf,
+        std::size_t send_count,
+        void *recvbuf,
+        std::vector<std::size_t> const &recv_counts,
+        std::vector<std::size_t> const &recv_displs,
+        datatype const &datatype_arg,
+        int root) const
+    {
+        MPICXX_INSTRUMENT("igatherv", implementation, send_count, datatype_arg.get());
+        bool is_root = rank() == root;
+        if (is_root)
+        {
+            check_per_rank(recv_counts, recv_displs, size());
+        }
+#if MPI_VERSION >= 4
+        std::unique_ptr<count_arrays_continuation> arrays(new count_arrays_continuation);
+        if (is_root)
+        {
+            arrays->recv_counts.assign(recv_counts.begin(), recv_counts.end());
+            arrays->recv_displs.assign(recv_displs.begin(), recv_displs.end());
+        }
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Igatherv_c(
+                sendbuf,
+                MPI_Count(send_count),
+                datatype_arg.get(),
+                recvbuf,
+                arrays->recv_counts.data(),
+                arrays->recv_displs.data(),
+                datatype_arg.get(),
+                root,
+                implementation,
+                &request_implementation));
+        return request(
+            request_implementation,
+            std::unique_ptr<details::request_continuation>(arrays.release()));
+#else
+        comm phase(phase_comm(implementation), false);
+        MPI_Aint extent = extent_of(datatype_arg);
+        bool in_place = sendbuf == MPI_IN_PLACE;
+        std::vector<MPI_Request> requests;
+        if (is_root)
+        {
+            for (int source = 0; source < size(); ++source)
+            {
+                if (recv_counts[source] != 0 && !(source == root && in_place))
+                {
+                    requests.push_back(
+                        phase.irecv_count(
+                                 advance(recvbuf, MPI_Aint(recv_displs[source]) * extent),
+                                 recv_counts[source],
+                                 datatype_arg,
+                                 source,
+                                 0)
+                            .release());
+                }
+            }
+        }
+        if (send_count != 0 && !in_place)
+        {
+            requests.push_back(phase.isend_count(sendbuf, send_count, datatype_arg, root, 0).release());
+        }
+        return join_requests(std::move(requests));
+#endif
+    }
+
+    request comm::iscatterv_count(
+        void const *sendbuf,
+        std::vector<std::size_t> const &send_counts,
+        std::vector<std::size_t> const &send_displs,
+        void *recvbuf,
+        std::size_t recv_count,
+        datatype const &datatype_arg,
+        int root) const
+    {
+        MPICXX_INSTRUMENT("iscatterv", implementation, recv_count, datatype_arg.get());
+        bool is_root = rank() == root;
+        if (is_root)
+        {
+            check_per_rank(send_counts, send_displs, size());
+        }
+#if MPI_VERSION >= 4
+        std::unique_ptr<count_arrays_continuation> arrays(new count_arrays_continuation);
+        if (is_root)
+        {
+            arrays->send_counts.assign(send_counts.begin(), send_counts.end());
+            arrays->send_displs.assign(send_displs.begin(), send_displs.end());
+        }
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Iscatterv_c(
+                sendbuf,
+                arrays->send_counts.data(),
+                arrays->send_displs.data(),
+                datatype_arg.get(),
+                recvbuf,
+                MPI_Count(recv_count),
+                datatype_arg.get(),
+                root,
+                implementation,
+                &request_implementation));
+        return request(
+            request_implementation,
+            std::unique_ptr<details::request_continuation>(arrays.release()));
+#else
+        comm phase(phase_comm(implementation), false);
+        MPI_Aint extent = extent_of(datatype_arg);
+        bool in_place = recvbuf == MPI_IN_PLACE;
+        std::vector<MPI_Request> requests;
+        if (recv_count != 0 && !in_place)
+        {
+            requests.push_back(phase.irecv_count(recvbuf, recv_count, datatype_arg, root, 0).release());
+        }
+        if (is_root)
+        {
+            for (int dest = 0; dest < size(); ++dest)
+            {
+                if (send_counts[dest] != 0 && !(dest == root && in_place))
+                {
+                    requests.push_back(
+                        phase.isend_count(
+                                 advance(sendbuf, MPI_Aint(send_displs[dest]) * extent),
+                                 send_counts[dest],
+                                 datatype_arg,
+                                 dest,
+                                 0)
+                            .release());
+                }
+            }
+        }
+        return join_requests(std::move(requests));
+#endif
+    }
+
+    request comm::iallgatherv_count(
+        void const *sendbuf,
+        std::size_t send_count,
+        void *recvbuf,
+        std::vector<std::size_t> const &recv_counts,
+        std::vector<std::size_t> const &recv_displs,
+        datatype const &datatype_arg) const
+    {
+        MPICXX_INSTRUMENT("iallgatherv", implementation, send_count, datatype_arg.get());
+        check_per_rank(recv_counts, recv_displs, size());
+#if MPI_VERSION >= 4
+        std::unique_ptr<count_arrays_continuation> arrays(new count_arrays_continuation);
+        arrays->recv_counts.assign(recv_counts.begin(), recv_counts.end());
+        arrays->recv_displs.assign(recv_displs.begin(), recv_displs.end());
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Iallgatherv_c(
+                sendbuf,
+                MPI_Count(send_count),
+                datatype_arg.get(),
+                recvbuf,
+                arrays->recv_counts.data(),
+                arrays->recv_displs.data(),
+                datatype_arg.get(),
+                implementation,
+                &request_implementation));
+        return request(
+            request_implementation,
+            std::unique_ptr<details::request_continuation>(arrays.release()));
+#else
+        comm phase(phase_comm(implementation), false);
+        MPI_Aint extent = extent_of(datatype_arg);
+        int self = rank();
+        bool in_place = sendbuf == MPI_IN_PLACE;
+        // In place, this rank's contribution already sits in its slot.
+        void const *contribution = in_place ? advance(static_cast<void const *>(recvbuf), MPI_Aint(recv_displs[self]) * extent) : sendbuf;
+        std::size_t contribution_count = in_place ? recv_counts[self] : send_count;
+        std::vector<MPI_Request> requests;
+        for (int source = 0; source < size(); ++source)
+        {
+            if (recv_counts[source] != 0 && !(source == self && in_place))
+            {
+                requests.push_back(
+                    phase.irecv_count(
+                             advance(recvbuf, MPI_Aint(recv_displs[source]) * extent),
+                             recv_counts[source],
+                             datatype_arg,
+                             source,
+                             0)
+                        .release());
+            }
+        }
+        for (int dest = 0; dest < size(); ++dest)
+        {
+            if (contribution_count != 0 && !(dest == self && in_place))
+            {
+                requests.push_back(phase.isend_count(contribution, contribution_count, datatype_arg, dest, 0).release());
+            }
+        }
+        return join_requests(std::move(requests));
+#endif
+    }
 
-namespace mpicxx
-{
+    request comm::ialltoallv_count(
+        void const *sendbuf,
+        std::vector<std::size_t> const &send_counts,
+        std::vector<std::size_t> const &send_displs,
+        void *recvbuf,
+        std::vector<std::size_t> const &recv_counts,
+        std::vector<std::size_t> const &recv_displs,
+        datatype const &datatype_arg) const
+    {
+        check_per_rank(send_counts, send_displs, size());
+        check_per_rank(recv_counts, recv_displs, size());
+        MPICXX_INSTRUMENT("ialltoallv", implementation, std::accumulate(send_counts.begin(), send_counts.end(), std::size_t(0)), datatype_arg.get());
+#if MPI_VERSION >= 4
+        std::unique_ptr<count_arrays_continuation> arrays(new count_arrays_continuation);
+        arrays->send_counts.assign(send_counts.begin(), send_counts.end());
+        arrays->send_displs.assign(send_displs.begin(), send_displs.end());
+        arrays->recv_counts.assign(recv_counts.begin(), recv_counts.end());
+        arrays->recv_displs.assign(recv_displs.begin(), recv_displs.end());
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Ialltoallv_c(
+                sendbuf,
+                arrays->send_counts.data(),
+                arrays->send_displs.data(),
+                datatype_arg.get(),
+                recvbuf,
+                arrays->recv_counts.data(),
+                arrays->recv_displs.data(),
+                datatype_arg.get(),
+                implementation,
+                &request_implementation));
+        return request(
+            request_implementation,
+            std::unique_ptr<details::request_continuation>(arrays.release()));
+#else
+        comm phase(phase_comm(implementation), false);
+        MPI_Aint extent = extent_of(datatype_arg);
+        std::vector<MPI_Request> requests;
+        for (int source = 0; source < size(); ++source)
+        {
+            if (recv_counts[source] != 0)
+            {
+                requests.push_back(
+                    phase.irecv_count(
+                             advance(recvbuf, MPI_Aint(recv_displs[source]) * extent),
+                             recv_counts[source],
+                             datatype_arg,
+                             source,
+                             0)
+                        .release());
+            }
+        }
+        for (int dest = 0; dest < size(); ++dest)
+        {
+            if (send_counts[dest] != 0)
+            {
+                requests.push_back(
+                    phase.isend_count(
+                             advance(sendbuf, MPI_Aint(send_displs[dest]) * extent),
+                             send_counts[dest],
+                             datatype_arg,
+                             dest,
+                             0)
+                        .release());
+            }
+        }
+        return join_requests(std::move(requests));
+#endif
+    }
 
-    comm &comm::operator=(comm &&other)
+    request comm::iallreduce_pipelined(
+        void const *sendbuf,
+        void *recvbuf,
+        std::size_t count,
+        datatype const &datatype_arg,
+        op const &op_arg,
+        std::size_t segment,
+        std::function<void(std::size_t, std::size_t)> on_segment,
+        int depth) const
+    {
+        return iallreduce_segmented(sendbuf, recvbuf, count, datatype_arg, op(op_arg.get(), false), segment, std::move(on_segment), depth);
+    }
+
+    request comm::iallreduce_pipelined(
+        void const *sendbuf,
+        void *recvbuf,
+        std::size_t count,
+        datatype const &datatype_arg,
+        op &&op_arg,
+        std::size_t segment,
+        std::function<void(std::size_t, std::size_t)> on_segment,
+        int depth) const
+    {
+        return iallreduce_segmented(sendbuf, recvbuf, count, datatype_arg, std::move(op_arg), segment, std::move(on_segment), depth);
+    }
+
+    request comm::iallreduce_segmented(
+        void const *sendbuf,
+        void *recvbuf,
+        std::size_t count,
+        datatype const &datatype_arg,
+        op op_arg,
+        std::size_t segment,
+        std::function<void(std::size_t, std::size_t)> on_segment,
+        int depth) const
     {
-        if (owned)
+        MPICXX_INSTRUMENT("iallreduce_pipelined", implementation, count, datatype_arg.get());
+        MPI_Aint lb;
+        MPI_Aint extent;
+        handle_error(MPI_Type_get_extent(datatype_arg.get(), &lb, &extent));
+        std::unique_ptr<segmented_continuation> continuation(new segmented_continuation);
+        continuation->element_type = duplicate_datatype(datatype_arg);
+        continuation->reduction = std::move(op_arg);
+        continuation->on_segment = std::move(on_segment);
+        segmented_continuation const *state = continuation.get();
+        continuation->start_segment = [=](std::size_t offset, std::size_t length)
         {
-            handle_error(MPI_Comm_free(&implementation));
+            MPI_Aint byte_offset = MPI_Aint(offset) * extent;
+            MPI_Request segment_implementation;
+            handle_error(
+                MPI_Iallreduce(
+                    sendbuf == MPI_IN_PLACE ? MPI_IN_PLACE : static_cast<char const *>(sendbuf) + byte_offset,
+                    static_cast<char *>(recvbuf) + byte_offset,
+                    int(length),
+                    state->element_type.get(),
+                    state->reduction.get(),
+                    state->segments,
+                    &segment_implementation));
+            return segment_implementation;
+        };
+        return start_segmented(implementation, std::move(continuation), count, segment, depth);
+    }
+
+    request comm::ibcast_pipelined(
+        void *buf,
+        std::size_t count,
+        datatype const &datatype_arg,
+        int root,
+        std::size_t segment,
+        std::function<void(std::size_t, std::size_t)> on_segment,
+        int depth) const
+    {
+        MPICXX_INSTRUMENT("ibcast_pipelined", implementation, count, datatype_arg.get());
+        MPI_Aint lb;
+        MPI_Aint extent;
+        handle_error(MPI_Type_get_extent(datatype_arg.get(), &lb, &extent));
+        std::unique_ptr<segmented_continuation> continuation(new segmented_continuation);
+        continuation->element_type = duplicate_datatype(datatype_arg);
+        continuation->on_segment = std::move(on_segment);
+        segmented_continuation const *state = continuation.get();
+        continuation->start_segment = [=](std::size_t offset, std::size_t length)
+        {
+            MPI_Request segment_implementation;
+            handle_error(
+                MPI_Ibcast(
+                    static_cast<char *>(buf) + MPI_Aint(offset) * extent,
+                    int(length),
+                    state->element_type.get(),
+                    root,
+                    state->segments,
+                    &segment_implementation));
+            return segment_implementation;
+        };
+        return start_segmented(implementation, std::move(continuation), count, segment, depth);
+    }
+
+    request comm::ibcast_count(
+        void *buf,
+        std::size_t count,
+        datatype const &datatype_arg,
+        int root) const
+    {
+        MPICXX_INSTRUMENT("ibcast", implementation, count, datatype_arg.get());
+        MPI_Request request_implementation;
+        if (fits_int(count))
+        {
+            handle_error(
+                MPI_Ibcast(
+                    buf,
+                    int(count),
+                    datatype_arg.get(),
+                    root,
+                    implementation,
+                    &request_implementation));
+            return request(request_implementation);
         }
-        implementation = other.implementation;
-        owned = other.owned;
-        other.implementation = MPI_COMM_NULL;
-        other.owned = false;
-        return *this;
+#if MPI_VERSION >= 4
+        handle_error(
+            MPI_Ibcast_c(
+                buf,
+                MPI_Count(count),
+                datatype_arg.get(),
+                root,
+                implementation,
+                &request_implementation));
+#else
+        datatype large_type = details::large_count_datatype(count, datatype_arg);
+        handle_error(
+            MPI_Ibcast(
+                buf,
+                1,
+                large_type.get(),
+                root,
+                implementation,
+                &request_implementation));
+#endif
+        return request(request_implementation);
     }
 
-    comm::~comm()
+    request comm::ibcast_any_size(
+        void *buf,
+        std::size_t count,
+        datatype const &datatype_arg,
+        std::function<void *(std::size_t)> resize,
+        std::function<void()> done,
+        int root) const
     {
-        if (owned)
+        MPICXX_INSTRUMENT("ibcast_any_size", implementation, count, datatype_arg.get());
+        std::unique_ptr<any_size_bcast_continuation> continuation(new any_size_bcast_continuation);
+        continuation->element_type = duplicate_datatype(datatype_arg);
+        continuation->phase = phase_comm(implementation);
+        continuation->root = root;
+        continuation->is_root = rank() == root;
+        continuation->resize = std::move(resize);
+        if (continuation->is_root)
         {
-            handle_error(MPI_Comm_free(&implementation));
+            continuation->header.count = count;
+            if (fits_eager_header(count, datatype_arg.get()))
+            {
+                int size;
+                handle_error(MPI_Type_size(datatype_arg.get(), &size));
+                if (count != 0)
+                {
+                    std::memcpy(continuation->header.payload, buf, count * std::size_t(size));
+                }
+            }
+            continuation->root_buffer = buf;
         }
+        else
+        {
+            continuation->done = std::move(done);
+        }
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Ibcast(
+                &continuation->header,
+                int(sizeof(any_size_header)),
+                MPI_BYTE,
+                root,
+                implementation,
+                &request_implementation));
+        return request(
+            request_implementation,
+            std::unique_ptr<details::request_continuation>(continuation.release()));
     }
 
-    int comm::size() const
+    request comm::isend_packed(
+        std::vector<char> packed,
+        int dest,
+        int tag) const
     {
-        int result_size;
+        MPICXX_INSTRUMENT("isend", implementation, packed.size(), MPI_BYTE);
+        using continuation_type = details::buffer_continuation<std::vector<char>>;
+        std::unique_ptr<continuation_type> continuation(new continuation_type(std::move(packed)));
+        request started = isend_count(
+            continuation->buffer.data(),
+            continuation->buffer.size(),
+            datatype::predefined_byte(),
+            dest,
+            tag);
+        return request(
+            started.release(),
+            std::unique_ptr<details::request_continuation>(continuation.release()));
+    }
+
+    request comm::imrecv_packed(
+        message &message_arg,
+        status const &status_arg,
+        std::function<void(std::vector<char> const &)> done) const
+    {
+        MPICXX_INSTRUMENT("imrecv", implementation, std::size_t(status_arg.get_count(datatype::predefined_byte())), MPI_BYTE);
+        std::unique_ptr<packed_recv_continuation> continuation(new packed_recv_continuation);
+        int size = status_arg.get_count(datatype::predefined_byte());
+        continuation->packed.resize(size);
+        continuation->done = std::move(done);
+        request started = imrecv(
+            continuation->packed.data(),
+            size,
+            datatype::predefined_byte(),
+            message_arg);
+        return request(
+            started.release(),
+            std::unique_ptr<details::request_continuation>(continuation.release()));
+    }
+
+    request comm::igatherv_packed(
+        std::vector<char> packed,
+        std::function<void(std::vector<char> const &, std::vector<std::size_t> const &)> done,
+        int root) const
+    {
+        MPICXX_INSTRUMENT("igatherv", implementation, packed.size(), MPI_BYTE);
+        std::unique_ptr<packed_gather_continuation> continuation(new packed_gather_continuation);
+        continuation->packed = std::move(packed);
+        continuation->packed_size = details::checked_count(continuation->packed.size());
+        continuation->phase = phase_comm(implementation);
+        continuation->root = root;
+        continuation->is_root = rank() == root;
+        if (continuation->is_root)
+        {
+            continuation->sizes.resize(size());
+            continuation->done = std::move(done);
+        }
+        MPI_Request request_implementation;
         handle_error(
-            MPI_Comm_size(
+            MPI_Igather(
+                &continuation->packed_size,
+                1,
+                MPI_INT,
+                continuation->sizes.data(),
+                1,
+                MPI_INT,
+                root,
                 implementation,
-                &result_size));
-        return result_size;
+                &request_implementation));
+        return request(
+            request_implementation,
+            std::unique_ptr<details::request_continuation>(continuation.release()));
     }
 
-    int comm::rank() const
+    persistent_request comm::send_init_count(
+        void const *buf,
+        std::size_t count,
+        datatype const &datatype_arg,
+        int dest,
+        int tag) const
     {
-        int result_rank;
+        MPI_Request request_implementation;
+        if (fits_int(count))
+        {
+            return send_init(buf, int(count), datatype_arg, dest, tag);
+        }
+#if MPI_VERSION >= 4
         handle_error(
-            MPI_Comm_rank(
+            MPI_Send_init_c(
+                buf,
+                MPI_Count(count),
+                datatype_arg.get(),
+                dest,
+                tag,
                 implementation,
-                &result_rank));
-        return result_rank;
+                &request_implementation));
+#else
+        datatype large_type = details::large_count_datatype(count, datatype_arg);
+        handle_error(
+            MPI_Send_init(
+                buf,
+                1,
+                large_type.get(),
+                dest,
+                tag,
+                implementation,
+                &request_implementation));
+#endif
+        return persistent_request(request_implementation);
     }
 
-    request comm::iallreduce(
-        void const *sendbuf,
-        void *recvbuf,
-        int count,
+    persistent_request comm::recv_init_count(
+        void *buf,
+        std::size_t count,
         datatype const &datatype_arg,
-        op const &op_arg)
+        int source,
+        int tag) const
     {
         MPI_Request request_implementation;
+        if (fits_int(count))
+        {
+            return recv_init(buf, int(count), datatype_arg, source, tag);
+        }
+#if MPI_VERSION >= 4
         handle_error(
-            MPI_Iallreduce(
-                sendbuf,
-                recvbuf,
-                count,
+            MPI_Recv_init_c(
+                buf,
+                MPI_Count(count),
                 datatype_arg.get(),
-                op_arg.get(),
+                source,
+                tag,
                 implementation,
                 &request_implementation));
-        return request(request_implementation);
+#else
+        datatype large_type = details::large_count_datatype(count, datatype_arg);
+        handle_error(
+            MPI_Recv_init(
+                buf,
+                1,
+                large_type.get(),
+                source,
+                tag,
+                implementation,
+                &request_implementation));
+#endif
+        return persistent_request(request_implementation);
     }
 
-    request comm::isend(
+    std::size_t comm::partition_count(std::size_t size, int partitions)
+    {
+        if (partitions <= 0 || size % std::size_t(partitions) != 0)
+        {
+            throw exception("mpicxx: partitioned buffer size is not a multiple of the partition count");
+        }
+        return size / std::size_t(partitions);
+    }
+
+    std::size_t comm::block_count(std::size_t size, int ranks)
+    {
+        if (size % std::size_t(ranks) != 0)
+        {
+            throw exception("mpicxx: alltoall buffer size is not a multiple of the communicator size");
+        }
+        return size / std::size_t(ranks);
+    }
+
+#if MPI_VERSION >= 4
+    partitioned_request comm::psend_init(
         void const *buf,
-        int count,
-        datatype datatype_arg,
+        int partitions,
+        std::size_t count,
+        datatype const &datatype_arg,
         int dest,
-        int tag)
+        int tag,
+        MPI_Info info) const
     {
         MPI_Request request_implementation;
         handle_error(
-            MPI_Isend(
+            MPI_Psend_init(
                 buf,
-                count,
+                partitions,
+                MPI_Count(count),
                 datatype_arg.get(),
                 dest,
                 tag,
                 implementation,
+                info,
                 &request_implementation));
-        return request(request_implementation);
+        return partitioned_request(request_implementation);
     }
 
-    request comm::irecv(
+    partitioned_request comm::precv_init(
         void *buf,
-        int count,
-        datatype datatype_arg,
-        int dest,
-        int tag)
+        int partitions,
+        std::size_t count,
+        datatype const &datatype_arg,
+        int source,
+        int tag,
+        MPI_Info info) const
     {
         MPI_Request request_implementation;
         handle_error(
-            MPI_Irecv(
+            MPI_Precv_init(
                 buf,
-                count,
+                partitions,
+                MPI_Count(count),
                 datatype_arg.get(),
-                dest,
+                source,
+                tag,
+                implementation,
+                info,
+                &request_implementation));
+        return partitioned_request(request_implementation);
+    }
+#else
+    std::vector<MPI_Request> comm::partition_requests(
+        void const *buf,
+        int partitions,
+        std::size_t count,
+        datatype const &datatype_arg,
+        int peer,
+        int tag,
+        bool receiving) const
+    {
+        int *tag_ub;
+        int flag;
+        handle_error(MPI_Comm_get_attr(implementation, MPI_TAG_UB, &tag_ub, &flag));
+        if (partitions <= 0 || (flag && tag > *tag_ub - (partitions - 1)))
+        {
+            throw exception("mpicxx: partitioned operation needs tags beyond MPI_TAG_UB");
+        }
+        MPI_Aint lower_bound, extent;
+        handle_error(MPI_Type_get_extent(datatype_arg.get(), &lower_bound, &extent));
+        char *base = static_cast<char *>(const_cast<void *>(buf));
+        std::vector<MPI_Request> implementations(partitions, MPI_REQUEST_NULL);
+        try
+        {
+            for (int partition = 0; partition < partitions; ++partition)
+            {
+                void *part = base + MPI_Aint(count) * extent * partition;
+                if (receiving)
+                {
+                    handle_error(
+                        MPI_Recv_init(
+                            part,
+                            details::checked_count(count),
+                            datatype_arg.get(),
+                            peer,
+                            tag + partition,
+                            implementation,
+                            &implementations[partition]));
+                }
+                else
+                {
+                    handle_error(
+                        MPI_Send_init(
+                            part,
+                            details::checked_count(count),
+                            datatype_arg.get(),
+                            peer,
+                            tag + partition,
+                            implementation,
+                            &implementations[partition]));
+                }
+            }
+        }
+        catch (...)
+        {
+            for (MPI_Request &created : implementations)
+            {
+                if (created != MPI_REQUEST_NULL)
+                {
+                    MPI_Request_free(&created);
+                }
+            }
+            throw;
+        }
+        return implementations;
+    }
+
+    partitioned_request comm::psend_init(
+        void const *buf,
+        int partitions,
+        std::size_t count,
+        datatype const &datatype_arg,
+        int dest,
+        int tag,
+        MPI_Info) const
+    {
+        return partitioned_request(
+            partition_requests(buf, partitions, count, datatype_arg, dest, tag, false),
+            false);
+    }
+
+    partitioned_request comm::precv_init(
+        void *buf,
+        int partitions,
+        std::size_t count,
+        datatype const &datatype_arg,
+        int source,
+        int tag,
+        MPI_Info) const
+    {
+        return partitioned_request(
+            partition_requests(buf, partitions, count, datatype_arg, source, tag, true),
+            true);
+    }
+#endif
+
+    status comm::probe(int source, int tag) const
+    {
+        MPI_Status status_implementation;
+        handle_error(
+            MPI_Probe(
+                source,
+                tag,
+                implementation,
+                &status_implementation));
+        return status(status_implementation);
+    }
+
+    bool comm::iprobe(int source, int tag, status &status_arg) const
+    {
+        int flag;
+        MPI_Status status_implementation;
+        handle_error(
+            MPI_Iprobe(
+                source,
+                tag,
+                implementation,
+                &flag,
+                &status_implementation));
+        if (flag)
+        {
+            status_arg = status(status_implementation);
+        }
+        return bool(flag);
+    }
+
+    message comm::mprobe(int source, int tag, status &status_arg) const
+    {
+        MPI_Message message_implementation;
+        MPI_Status status_implementation;
+        handle_error(
+            MPI_Mprobe(
+                source,
+                tag,
+                implementation,
+                &message_implementation,
+                &status_implementation));
+        status_arg = status(status_implementation);
+        return message(message_implementation);
+    }
+
+    bool comm::improbe(int source, int tag, message &message_arg, status &status_arg) const
+    {
+        int flag;
+        MPI_Status status_implementation;
+        handle_error(
+            MPI_Improbe(
+                source,
                 tag,
                 implementation,
+                &flag,
+                &message_arg.get(),
+                &status_implementation));
+        if (flag)
+        {
+            status_arg = status(status_implementation);
+        }
+        return bool(flag);
+    }
+
+    request comm::imrecv(
+        void *buf,
+        int count,
+        datatype const &datatype_arg,
+        message &message_arg) const
+    {
+        MPICXX_INSTRUMENT("imrecv", implementation, std::size_t(count), datatype_arg.get());
+        MPI_Request request_implementation;
+        handle_error(
+            MPI_Imrecv(
+                buf,
+                count,
+                datatype_arg.get(),
+                &message_arg.get(),
                 &request_implementation));
         return request(request_implementation);
     }
@@ -127,8 +2200,14 @@ namespace mpicxx
         return comm(new_implementation, true);
     }
 
+    void comm::quiesce() const
+    {
+        details::drain_detached();
+    }
+
     request comm::ibarrier() const
     {
+        MPICXX_INSTRUMENT("ibarrier", implementation, 0, MPI_BYTE);
         MPI_Request request_implementation;
         handle_error(
             MPI_Ibarrier(
@@ -225,4 +2304,98 @@ namespace mpicxx
                 maxdims,
                 coords));
     }
+
+    comm comm::dist_graph_create_adjacent(
+        std::vector<int> const &sources,
+        std::vector<int> const &sourceweights,
+        std::vector<int> const &destinations,
+        std::vector<int> const &destweights,
+        int reorder,
+        MPI_Info info) const
+    {
+        if (sourceweights.size() != sources.size() || destweights.size() != destinations.size())
+        {
+            throw exception("mpicxx: dist_graph_create_adjacent needs one weight per neighbor");
+        }
+        MPI_Comm graph_implementation;
+        handle_error(
+            MPI_Dist_graph_create_adjacent(
+                implementation,
+                int(sources.size()),
+                sources.data(),
+                sources.empty() ? MPI_WEIGHTS_EMPTY : sourceweights.data(),
+                int(destinations.size()),
+                destinations.data(),
+                destinations.empty() ? MPI_WEIGHTS_EMPTY : destweights.data(),
+                info,
+                reorder,
+                &graph_implementation));
+        return comm(graph_implementation, true);
+    }
+
+    comm comm::dist_graph_create_adjacent(
+        std::vector<int> const &sources,
+        std::vector<int> const &destinations,
+        int reorder,
+        MPI_Info info) const
+    {
+        MPI_Comm graph_implementation;
+        handle_error(
+            MPI_Dist_graph_create_adjacent(
+                implementation,
+                int(sources.size()),
+                sources.data(),
+                MPI_UNWEIGHTED,
+                int(destinations.size()),
+                destinations.data(),
+                MPI_UNWEIGHTED,
+                info,
+                reorder,
+                &graph_implementation));
+        return comm(graph_implementation, true);
+    }
+
+    void comm::dist_graph_neighbors_count(int &indegree, int &outdegree) const
+    {
+        int weighted;
+        handle_error(
+            MPI_Dist_graph_neighbors_count(
+                implementation,
+                &indegree,
+                &outdegree,
+                &weighted));
+    }
+
+    void comm::dist_graph_neighbors(
+        std::vector<int> &sources,
+        std::vector<int> &destinations) const
+    {
+        std::vector<int> sourceweights;
+        std::vector<int> destweights;
+        dist_graph_neighbors(sources, sourceweights, destinations, destweights);
+    }
+
+    void comm::dist_graph_neighbors(
+        std::vector<int> &sources,
+        std::vector<int> &sourceweights,
+        std::vector<int> &destinations,
+        std::vector<int> &destweights) const
+    {
+        int indegree;
+        int outdegree;
+        dist_graph_neighbors_count(indegree, outdegree);
+        sources.resize(indegree);
+        sourceweights.resize(indegree);
+        destinations.resize(outdegree);
+        destweights.resize(outdegree);
+        handle_error(
+            MPI_Dist_graph_neighbors(
+                implementation,
+                indegree,
+                sources.data(),
+                sourceweights.data(),
+                outdegree,
+                destinations.data(),
+                destweights.data()));
+    }
 } // namespace mpicxx
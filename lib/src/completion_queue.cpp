@@ -0,0 +1,170 @@
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+#include "error/exception.hpp"
+#include "handles/completion_queue.hpp"
+
+namespace mpicxx
+{
+    namespace
+    {
+        // Callbacks run with the mutex held, so a callback may detach again
+        // on the same thread. The thread-local flag keeps a wait issued from
+        // inside a reap from re-entering the queue mid-harvest.
+        std::recursive_mutex detached_mutex;
+        completion_queue detached;
+        std::atomic<bool> detached_pending{false};
+        thread_local bool reaping = false;
+
+        class reaping_scope
+        {
+            bool previous;
+
+        public:
+            reaping_scope()
+                : previous(reaping)
+            {
+                reaping = true;
+            }
+            ~reaping_scope()
+            {
+                reaping = previous;
+            }
+        };
+    }
+
+    void completion_queue::push(request &&request_arg, std::function<void(status const &)> callback)
+    {
+        if (request_arg.get() == MPI_REQUEST_NULL)
+        {
+            callback(status());
+            return;
+        }
+        requests.insert(std::move(request_arg));
+        callbacks.push_back(std::move(callback));
+    }
+
+    std::size_t completion_queue::complete(bool blocking)
+    {
+        if (blocking)
+        {
+            requests.wait_some(indices, statuses);
+        }
+        else
+        {
+            requests.test_some(indices, statuses);
+        }
+        if (indices.empty())
+        {
+            return 0;
+        }
+        // Completed callbacks are moved out and both arrays compacted before
+        // any of them runs, so a callback may push or poll re-entrantly.
+        std::vector<std::function<void(status const &)>> ready;
+        std::vector<status> ready_statuses(statuses);
+        ready.reserve(indices.size());
+        for (int index : indices)
+        {
+            ready.push_back(std::move(callbacks[index]));
+        }
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < callbacks.size(); ++i)
+        {
+            if (requests.get(i) != MPI_REQUEST_NULL)
+            {
+                callbacks[kept++] = std::move(callbacks[i]);
+            }
+        }
+        callbacks.resize(kept);
+        requests.compact();
+        for (std::size_t i = 0; i < ready.size(); ++i)
+        {
+            ready[i](ready_statuses[i]);
+        }
+        return ready.size();
+    }
+
+    std::size_t completion_queue::poll()
+    {
+        if (empty())
+        {
+            return 0;
+        }
+        return complete(false);
+    }
+
+    std::size_t completion_queue::wait()
+    {
+        if (empty())
+        {
+            return 0;
+        }
+        return complete(true);
+    }
+
+    void completion_queue::drain()
+    {
+        while (!empty())
+        {
+            complete(true);
+        }
+    }
+
+    completion_queue &completion_queue::local()
+    {
+        thread_local completion_queue queue;
+        return queue;
+    }
+
+    std::size_t progress()
+    {
+        details::reap_detached();
+        return completion_queue::local().poll();
+    }
+
+    namespace details
+    {
+        void detach(request &&request_arg, std::function<void(status const &)> callback)
+        {
+            std::lock_guard<std::recursive_mutex> lock(detached_mutex);
+            detached.push(std::move(request_arg), std::move(callback));
+            if (!reaping)
+            {
+                reaping_scope scope;
+                detached.poll();
+            }
+            detached_pending.store(!detached.empty(), std::memory_order_relaxed);
+        }
+
+        void reap_detached()
+        {
+            if (reaping || !detached_pending.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            std::unique_lock<std::recursive_mutex> lock(detached_mutex, std::try_to_lock);
+            if (!lock.owns_lock())
+            {
+                return;
+            }
+            reaping_scope scope;
+            detached.poll();
+            detached_pending.store(!detached.empty(), std::memory_order_relaxed);
+        }
+
+        void drain_detached()
+        {
+            std::lock_guard<std::recursive_mutex> lock(detached_mutex);
+            reaping_scope scope;
+            detached.drain();
+            detached_pending.store(false, std::memory_order_relaxed);
+        }
+
+        bool any_detached()
+        {
+            std::lock_guard<std::recursive_mutex> lock(detached_mutex);
+            return !detached.empty();
+        }
+    }
+}
@@ -1,3 +1,7 @@
+#include <limits>
+#include <mutex>
+#include <vector>
+
 #include "datatype/datatype.hpp"
 
 #include "error/exception.hpp"
@@ -25,6 +29,85 @@ namespace mpicxx
         }
     }
 
+    void datatype::commit()
+    {
+        handle_error(MPI_Type_commit(&implementation));
+    }
+
+    MPI_Datatype datatype::release()
+    {
+        MPI_Datatype result = implementation;
+        implementation = MPI_DATATYPE_NULL;
+        owned = false;
+        return result;
+    }
+
+    datatype datatype::create_contiguous(
+        int count,
+        datatype const &oldtype)
+    {
+        MPI_Datatype new_implementation;
+        handle_error(
+            MPI_Type_contiguous(
+                count,
+                oldtype.get(),
+                &new_implementation));
+        return datatype(new_implementation, true);
+    }
+
+    datatype datatype::create_struct(
+        int count,
+        int const blocklengths[],
+        MPI_Aint const displacements[],
+        MPI_Datatype const types[])
+    {
+        MPI_Datatype new_implementation;
+        handle_error(
+            MPI_Type_create_struct(
+                count,
+                blocklengths,
+                displacements,
+                types,
+                &new_implementation));
+        return datatype(new_implementation, true);
+    }
+
+    datatype datatype::create_resized(
+        datatype const &oldtype,
+        MPI_Aint lb,
+        MPI_Aint extent)
+    {
+        MPI_Datatype new_implementation;
+        handle_error(
+            MPI_Type_create_resized(
+                oldtype.get(),
+                lb,
+                extent,
+                &new_implementation));
+        return datatype(new_implementation, true);
+    }
+
+    datatype datatype::create_subarray(
+        int ndims,
+        int const sizes[],
+        int const subsizes[],
+        int const starts[],
+        int order,
+        datatype const &oldtype)
+    {
+        MPI_Datatype new_implementation;
+        handle_error(
+            MPI_Type_create_subarray(
+                ndims,
+                sizes,
+                subsizes,
+                starts,
+                order,
+                oldtype.get(),
+                &new_implementation));
+        return datatype(new_implementation, true);
+    }
+
     datatype datatype::predefined_byte()
     {
         return datatype(MPI_BYTE, false);
@@ -35,6 +118,26 @@ namespace mpicxx
         return datatype(MPI_CHAR, false);
     }
 
+    datatype datatype::predefined_signed_char()
+    {
+        return datatype(MPI_SIGNED_CHAR, false);
+    }
+
+    datatype datatype::predefined_unsigned_char()
+    {
+        return datatype(MPI_UNSIGNED_CHAR, false);
+    }
+
+    datatype datatype::predefined_short()
+    {
+        return datatype(MPI_SHORT, false);
+    }
+
+    datatype datatype::predefined_unsigned_short()
+    {
+        return datatype(MPI_UNSIGNED_SHORT, false);
+    }
+
     datatype datatype::predefined_unsigned()
     {
         return datatype(MPI_UNSIGNED, false);
@@ -55,6 +158,11 @@ namespace mpicxx
         return datatype(MPI_INT, false);
     }
 
+    datatype datatype::predefined_long()
+    {
+        return datatype(MPI_LONG, false);
+    }
+
     datatype datatype::predefined_long_long_int()
     {
         return datatype(MPI_LONG_LONG_INT, false);
@@ -70,6 +178,11 @@ namespace mpicxx
         return datatype(MPI_DOUBLE, false);
     }
 
+    datatype datatype::predefined_long_double()
+    {
+        return datatype(MPI_LONG_DOUBLE, false);
+    }
+
     datatype datatype::predefined_bool()
     {
         return datatype(MPI_C_BOOL, false);
@@ -79,4 +192,49 @@ namespace mpicxx
     {
         return datatype(MPI_PACKED, false);
     }
+
+    namespace details
+    {
+        namespace
+        {
+            std::mutex cached_datatypes_mutex;
+            std::vector<MPI_Datatype> cached_datatypes;
+        }
+
+        void register_cached_datatype(MPI_Datatype implementation)
+        {
+            std::lock_guard<std::mutex> lock(cached_datatypes_mutex);
+            cached_datatypes.push_back(implementation);
+        }
+
+        datatype large_count_datatype(std::size_t count, datatype const &oldtype)
+        {
+            // count = chunks * INT_MAX + remainder, expressed as a struct of a
+            // contiguous run of chunks followed by the remainder.
+            std::size_t const chunk = std::size_t(std::numeric_limits<int>::max());
+            std::size_t chunks = count / chunk;
+            std::size_t remainder = count % chunk;
+            MPI_Aint lb;
+            MPI_Aint extent;
+            handle_error(MPI_Type_get_extent(oldtype.get(), &lb, &extent));
+            datatype chunk_type = datatype::create_contiguous(int(chunk), oldtype);
+            datatype chunks_type = datatype::create_contiguous(int(chunks), chunk_type);
+            int const blocklengths[2] = {1, int(remainder)};
+            MPI_Aint const displacements[2] = {0, MPI_Aint(chunks * chunk) * extent};
+            MPI_Datatype const types[2] = {chunks_type.get(), oldtype.get()};
+            datatype result = datatype::create_struct(2, blocklengths, displacements, types);
+            result.commit();
+            return result;
+        }
+
+        void free_cached_datatypes()
+        {
+            std::lock_guard<std::mutex> lock(cached_datatypes_mutex);
+            for (MPI_Datatype &implementation : cached_datatypes)
+            {
+                handle_error(MPI_Type_free(&implementation));
+            }
+            cached_datatypes.clear();
+        }
+    }
 }
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "containers/dist_vector.hpp"
+#include "error/exception.hpp"
+
+namespace mpicxx
+{
+    dist_layout::dist_layout(std::size_t global_size_arg, int rank_count_arg, std::size_t cycle_block_arg)
+        : global_size(global_size_arg), rank_count(rank_count_arg), cycle_block(cycle_block_arg)
+    {
+        if (rank_count <= 0)
+        {
+            throw exception("mpicxx::dist_layout needs at least one rank");
+        }
+    }
+
+    dist_layout dist_layout::block(std::size_t global_size_arg, int rank_count_arg)
+    {
+        return dist_layout(global_size_arg, rank_count_arg, 0);
+    }
+
+    dist_layout dist_layout::block_cyclic(std::size_t global_size_arg, int rank_count_arg, std::size_t block_size_arg)
+    {
+        if (block_size_arg == 0)
+        {
+            throw exception("mpicxx::dist_layout block size must be nonzero");
+        }
+        return dist_layout(global_size_arg, rank_count_arg, block_size_arg);
+    }
+
+    int dist_layout::owner(std::size_t global_index) const
+    {
+        if (cycle_block != 0)
+        {
+            return int((global_index / cycle_block) % std::size_t(rank_count));
+        }
+        // The first global_size % rank_count ranks hold one extra element.
+        std::size_t base = global_size / std::size_t(rank_count);
+        std::size_t extra = global_size % std::size_t(rank_count);
+        std::size_t boundary = extra * (base + 1);
+        if (global_index < boundary)
+        {
+            return int(global_index / (base + 1));
+        }
+        return int(extra + (global_index - boundary) / base);
+    }
+
+    std::size_t dist_layout::local_index(std::size_t global_index) const
+    {
+        if (cycle_block != 0)
+        {
+            std::size_t global_block = global_index / cycle_block;
+            return global_block / std::size_t(rank_count) * cycle_block + global_index % cycle_block;
+        }
+        return global_index - this->global_index(owner(global_index), 0);
+    }
+
+    std::size_t dist_layout::global_index(int rank, std::size_t local_index_arg) const
+    {
+        if (cycle_block != 0)
+        {
+            std::size_t local_block_index = local_index_arg / cycle_block;
+            std::size_t global_block = local_block_index * std::size_t(rank_count) + std::size_t(rank);
+            return global_block * cycle_block + local_index_arg % cycle_block;
+        }
+        std::size_t base = global_size / std::size_t(rank_count);
+        std::size_t extra = global_size % std::size_t(rank_count);
+        return std::size_t(rank) * base + std::min(std::size_t(rank), extra) + local_index_arg;
+    }
+
+    std::size_t dist_layout::local_size(int rank) const
+    {
+        if (cycle_block == 0)
+        {
+            std::size_t base = global_size / std::size_t(rank_count);
+            return base + (std::size_t(rank) < global_size % std::size_t(rank_count) ? 1 : 0);
+        }
+        std::size_t blocks = local_blocks(rank);
+        if (blocks == 0)
+        {
+            return 0;
+        }
+        return (blocks - 1) * cycle_block + local_block(rank, blocks - 1).second;
+    }
+
+    std::size_t dist_layout::local_blocks(int rank) const
+    {
+        if (cycle_block == 0)
+        {
+            return local_size(rank) == 0 ? 0 : 1;
+        }
+        std::size_t global_blocks = (global_size + cycle_block - 1) / cycle_block;
+        if (std::size_t(rank) >= global_blocks)
+        {
+            return 0;
+        }
+        return (global_blocks - std::size_t(rank) - 1) / std::size_t(rank_count) + 1;
+    }
+
+    std::pair<std::size_t, std::size_t> dist_layout::local_block(int rank, std::size_t k) const
+    {
+        if (cycle_block == 0)
+        {
+            return std::make_pair(global_index(rank, 0), local_size(rank));
+        }
+        std::size_t first = (k * std::size_t(rank_count) + std::size_t(rank)) * cycle_block;
+        return std::make_pair(first, std::min(cycle_block, global_size - first));
+    }
+
+    namespace details
+    {
+        namespace
+        {
+            void displacements(std::vector<int> const &counts, std::vector<int> &displs)
+            {
+                displs.resize(counts.size());
+                std::size_t offset = 0;
+                for (std::size_t i = 0; i < counts.size(); ++i)
+                {
+                    displs[i] = checked_count(offset);
+                    offset += std::size_t(counts[i]);
+                }
+                checked_count(offset);
+            }
+        }
+
+        owner_plan plan_by_owner(comm const &comm_arg, dist_layout const &layout_arg, std::vector<std::size_t> const &indices)
+        {
+            int ranks = comm_arg.size();
+            owner_plan plan;
+            plan.send_counts.assign(ranks, 0);
+            std::vector<int> owners(indices.size());
+            for (std::size_t i = 0; i < indices.size(); ++i)
+            {
+                if (indices[i] >= layout_arg.size())
+                {
+                    throw exception("mpicxx::dist_vector index out of range");
+                }
+                owners[i] = layout_arg.owner(indices[i]);
+                ++plan.send_counts[owners[i]];
+            }
+            displacements(plan.send_counts, plan.send_displs);
+            // Stable counting sort by owner.
+            std::vector<int> cursor(plan.send_displs);
+            plan.order.resize(indices.size());
+            std::vector<std::uint64_t> wanted(indices.size());
+            for (std::size_t i = 0; i < indices.size(); ++i)
+            {
+                int position = cursor[owners[i]]++;
+                plan.order[position] = i;
+                wanted[position] = layout_arg.local_index(indices[i]);
+            }
+            plan.recv_counts.resize(ranks);
+            comm_arg.ialltoall(plan.send_counts.data(), plan.recv_counts.data(), 1).wait();
+            displacements(plan.recv_counts, plan.recv_displs);
+            plan.requested.resize(std::size_t(plan.recv_displs.empty() ? 0 : plan.recv_displs.back() + plan.recv_counts.back()));
+            comm_arg.ialltoallv(
+                        wanted.data(), plan.send_counts.data(), plan.send_displs.data(),
+                        plan.requested.data(), plan.recv_counts.data(), plan.recv_displs.data())
+                .wait();
+            return plan;
+        }
+
+        redistribution_plan plan_redistribution(dist_layout const &from, dist_layout const &to, int rank)
+        {
+            int ranks = from.ranks();
+            redistribution_plan plan;
+            plan.send_counts.assign(ranks, 0);
+            plan.recv_counts.assign(ranks, 0);
+            plan.destinations.resize(from.local_size(rank));
+            for (std::size_t i = 0; i < plan.destinations.size(); ++i)
+            {
+                plan.destinations[i] = to.owner(from.global_index(rank, i));
+                ++plan.send_counts[plan.destinations[i]];
+            }
+            plan.sources.resize(to.local_size(rank));
+            for (std::size_t i = 0; i < plan.sources.size(); ++i)
+            {
+                plan.sources[i] = from.owner(to.global_index(rank, i));
+                ++plan.recv_counts[plan.sources[i]];
+            }
+            displacements(plan.send_counts, plan.send_displs);
+            displacements(plan.recv_counts, plan.recv_displs);
+            return plan;
+        }
+    }
+}
@@ -1,10 +1,16 @@
 #include "mpienv/environment.hpp"
 
+#include "datatype/datatype.hpp"
 #include "error/exception.hpp"
+#include "handles/completion_queue.hpp"
+#include "instrumentation/instrumentation.hpp"
+#include "instrumentation/tracing.hpp"
+#include "reductionoperation/reductionop.hpp"
 
 namespace mpicxx
 {
     environment::environment(int &argc, char **&argv)
+        : provided(thread_level::single), progress_running(false), progress_comm(MPI_COMM_NULL)
     {
         int flag;
         handle_error(MPI_Initialized(&flag));
@@ -12,8 +18,18 @@ namespace mpicxx
         {
             handle_error(MPI_Init(&argc, &argv));
         }
+        query_thread_level();
+#ifdef MPICXX_ENABLE_TRACING
+        details::tracing::start();
+#endif
+    }
+    environment::environment(int &argc, char **&argv, thread_level required)
+        : provided(thread_level::single), progress_running(false), progress_comm(MPI_COMM_NULL)
+    {
+        initialize(&argc, &argv, int(required));
     }
     environment::environment()
+        : provided(thread_level::single), progress_running(false), progress_comm(MPI_COMM_NULL)
     {
         int flag;
         handle_error(MPI_Initialized(&flag));
@@ -21,6 +37,85 @@ namespace mpicxx
         {
             handle_error(MPI_Init(nullptr, nullptr));
         }
+        query_thread_level();
+#ifdef MPICXX_ENABLE_TRACING
+        details::tracing::start();
+#endif
+    }
+    environment::environment(thread_level required)
+        : provided(thread_level::single), progress_running(false), progress_comm(MPI_COMM_NULL)
+    {
+        initialize(nullptr, nullptr, int(required));
+    }
+
+    void environment::initialize(int *argc, char ***argv, int required)
+    {
+        int flag;
+        handle_error(MPI_Initialized(&flag));
+        if (!flag)
+        {
+            int provided_implementation;
+            handle_error(MPI_Init_thread(argc, argv, required, &provided_implementation));
+            provided = thread_level(provided_implementation);
+        }
+        else
+        {
+            query_thread_level();
+        }
+#ifdef MPICXX_ENABLE_TRACING
+        details::tracing::start();
+#endif
+    }
+
+    void environment::query_thread_level()
+    {
+        int provided_implementation;
+        handle_error(MPI_Query_thread(&provided_implementation));
+        provided = thread_level(provided_implementation);
+    }
+
+    void environment::start_progress_thread(std::chrono::microseconds poll_interval)
+    {
+        if (progress_thread.joinable())
+        {
+            return;
+        }
+        if (provided != thread_level::multiple)
+        {
+            throw exception("mpicxx::environment progress thread requires thread_level::multiple");
+        }
+        // A private communicator keeps the polling probe from ever matching
+        // a user message.
+        handle_error(MPI_Comm_dup(MPI_COMM_SELF, &progress_comm));
+        progress_running.store(true, std::memory_order_release);
+        progress_thread = std::thread(
+            [this, poll_interval]()
+            {
+                while (progress_running.load(std::memory_order_acquire))
+                {
+                    int flag;
+                    MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, progress_comm, &flag, MPI_STATUS_IGNORE);
+                    if (poll_interval.count() > 0)
+                    {
+                        std::this_thread::sleep_for(poll_interval);
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+    }
+
+    void environment::stop_progress_thread()
+    {
+        if (!progress_thread.joinable())
+        {
+            return;
+        }
+        progress_running.store(false, std::memory_order_release);
+        progress_thread.join();
+        handle_error(MPI_Comm_free(&progress_comm));
     }
 
     void environment::finalize()
@@ -29,6 +124,21 @@ namespace mpicxx
         handle_error(MPI_Finalized(&flag));
         if (!flag)
         {
+            // Callbacks in either queue may push into the other.
+            do
+            {
+                details::drain_detached();
+                completion_queue::local().drain();
+            } while (details::any_detached());
+            stop_progress_thread();
+#ifdef MPICXX_ENABLE_INSTRUMENTATION
+            details::instrumentation::report();
+#endif
+#ifdef MPICXX_ENABLE_TRACING
+            details::tracing::finish();
+#endif
+            details::free_cached_datatypes();
+            details::free_cached_ops();
             handle_error(MPI_Finalize());
         }
     }
@@ -0,0 +1,77 @@
+#include "error/exception.hpp"
+#include "onesided/epoch.hpp"
+
+namespace mpicxx
+{
+    namespace
+    {
+        MPI_Group window_subgroup(MPI_Win implementation, std::vector<int> const &ranks)
+        {
+            MPI_Group window_group;
+            MPI_Group subgroup;
+            handle_error(MPI_Win_get_group(implementation, &window_group));
+            handle_error(MPI_Group_incl(window_group, int(ranks.size()), ranks.data(), &subgroup));
+            handle_error(MPI_Group_free(&window_group));
+            return subgroup;
+        }
+    }
+
+    fence_epoch::fence_epoch(MPI_Win implementation_arg, int open_assert, int close_assert_arg)
+        : implementation(implementation_arg), close_assert(close_assert_arg)
+    {
+        handle_error(MPI_Win_fence(open_assert, implementation));
+    }
+
+    fence_epoch::~fence_epoch()
+    {
+        handle_error(MPI_Win_fence(close_assert, implementation));
+    }
+
+    lock_epoch::lock_epoch(MPI_Win implementation_arg, int rank_arg, int lock_type, int assert_arg)
+        : implementation(implementation_arg), rank(rank_arg)
+    {
+        handle_error(MPI_Win_lock(lock_type, rank, assert_arg, implementation));
+    }
+
+    lock_epoch::~lock_epoch()
+    {
+        handle_error(MPI_Win_unlock(rank, implementation));
+    }
+
+    lock_all_epoch::lock_all_epoch(MPI_Win implementation_arg, int assert_arg)
+        : implementation(implementation_arg)
+    {
+        handle_error(MPI_Win_lock_all(assert_arg, implementation));
+    }
+
+    lock_all_epoch::~lock_all_epoch()
+    {
+        handle_error(MPI_Win_unlock_all(implementation));
+    }
+
+    access_epoch::access_epoch(MPI_Win implementation_arg, std::vector<int> const &target_ranks, int assert_arg)
+        : implementation(implementation_arg)
+    {
+        MPI_Group group = window_subgroup(implementation, target_ranks);
+        handle_error(MPI_Win_start(group, assert_arg, implementation));
+        handle_error(MPI_Group_free(&group));
+    }
+
+    access_epoch::~access_epoch()
+    {
+        handle_error(MPI_Win_complete(implementation));
+    }
+
+    exposure_epoch::exposure_epoch(MPI_Win implementation_arg, std::vector<int> const &origin_ranks, int assert_arg)
+        : implementation(implementation_arg)
+    {
+        MPI_Group group = window_subgroup(implementation, origin_ranks);
+        handle_error(MPI_Win_post(group, assert_arg, implementation));
+        handle_error(MPI_Group_free(&group));
+    }
+
+    exposure_epoch::~exposure_epoch()
+    {
+        handle_error(MPI_Win_wait(implementation));
+    }
+}
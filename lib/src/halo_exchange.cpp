@@ -0,0 +1,124 @@
+#include <utility>
+
+#include "communicators/halo_exchange.hpp"
+#include "error/exception.hpp"
+
+namespace mpicxx
+{
+    namespace
+    {
+        // Directions are offsets in {-1, 0, 1} per dimension, encoded in base 3.
+        int encode_direction(std::vector<int> const &offset)
+        {
+            int code = 0;
+            for (int o : offset)
+            {
+                code = code * 3 + (o + 1);
+            }
+            return code;
+        }
+    }
+
+    halo_exchange::halo_exchange(
+        comm const &cart,
+        std::vector<int> const &local_extents,
+        int ghost_width,
+        void *data,
+        datatype const &element_type,
+        bool include_corners)
+        : neighbors(cart.dup())
+    {
+        int ndims = neighbors.cartdim_get();
+        if (ndims != int(local_extents.size()))
+        {
+            throw exception("mpicxx::halo_exchange extents do not match the Cartesian dimension");
+        }
+        std::vector<int> dims(ndims), periods(ndims), coords(ndims);
+        neighbors.cart_get(ndims, dims.data(), periods.data(), coords.data());
+        std::vector<int> sizes(ndims);
+        for (int d = 0; d < ndims; ++d)
+        {
+            if (ghost_width < 1 || ghost_width > local_extents[d])
+            {
+                throw exception("mpicxx::halo_exchange ghost width must be between 1 and the local extent");
+            }
+            sizes[d] = local_extents[d] + 2 * ghost_width;
+        }
+
+        int directions = 1;
+        for (int d = 0; d < ndims; ++d)
+        {
+            directions *= 3;
+        }
+        std::vector<persistent_request> sends;
+        std::vector<int> offset(ndims), negated(ndims), neighbor(ndims);
+        std::vector<int> subsizes(ndims), send_starts(ndims), recv_starts(ndims);
+        for (int code = 0; code < directions; ++code)
+        {
+            int nonzero = 0;
+            for (int d = ndims - 1, rest = code; d >= 0; --d, rest /= 3)
+            {
+                offset[d] = rest % 3 - 1;
+                negated[d] = -offset[d];
+                nonzero += offset[d] != 0;
+            }
+            if (nonzero == 0 || (!include_corners && nonzero > 1))
+            {
+                continue;
+            }
+
+            int neighbor_rank = 0;
+            for (int d = 0; d < ndims; ++d)
+            {
+                neighbor[d] = coords[d] + offset[d];
+                if (neighbor[d] < 0 || neighbor[d] >= dims[d])
+                {
+                    if (!periods[d])
+                    {
+                        neighbor_rank = MPI_PROC_NULL;
+                        break;
+                    }
+                    neighbor[d] = (neighbor[d] + dims[d]) % dims[d];
+                }
+            }
+            if (neighbor_rank != MPI_PROC_NULL)
+            {
+                neighbor_rank = neighbors.cart_rank(neighbor.data());
+            }
+
+            for (int d = 0; d < ndims; ++d)
+            {
+                subsizes[d] = offset[d] == 0 ? local_extents[d] : ghost_width;
+                send_starts[d] = offset[d] > 0 ? local_extents[d] : ghost_width;
+                recv_starts[d] = offset[d] < 0 ? 0 : (offset[d] > 0 ? ghost_width + local_extents[d] : ghost_width);
+            }
+            datatype send_type = datatype::create_subarray(
+                ndims, sizes.data(), subsizes.data(), send_starts.data(), MPI_ORDER_C, element_type);
+            send_type.commit();
+            datatype recv_type = datatype::create_subarray(
+                ndims, sizes.data(), subsizes.data(), recv_starts.data(), MPI_ORDER_C, element_type);
+            recv_type.commit();
+
+            // What we send towards offset arrives at that neighbor from its
+            // -offset side, so receives are matched on the negated direction.
+            requests.push_back(neighbors.recv_init(data, 1, recv_type, neighbor_rank, encode_direction(negated)));
+            sends.push_back(neighbors.send_init(data, 1, send_type, neighbor_rank, encode_direction(offset)));
+            types.push_back(std::move(send_type));
+            types.push_back(std::move(recv_type));
+        }
+        for (persistent_request &send : sends)
+        {
+            requests.push_back(std::move(send));
+        }
+    }
+
+    void halo_exchange::start()
+    {
+        startall(int(requests.size()), requests.data());
+    }
+
+    void halo_exchange::finish()
+    {
+        waitall(int(requests.size()), requests.data());
+    }
+}
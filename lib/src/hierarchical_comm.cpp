@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "communicators/hierarchical_comm.hpp"
+#include "error/exception.hpp"
+
+namespace mpicxx
+{
+    namespace
+    {
+        std::size_t extent_of(datatype const &datatype_arg)
+        {
+            MPI_Aint lb;
+            MPI_Aint extent;
+            handle_error(MPI_Type_get_extent(datatype_arg.get(), &lb, &extent));
+            return std::size_t(extent);
+        }
+    }
+
+    hierarchical_comm::hierarchical_comm(comm const &parent)
+    {
+        node = parent.split_type(MPI_COMM_TYPE_SHARED, parent.rank());
+        build(parent);
+    }
+
+    hierarchical_comm::hierarchical_comm(comm const &parent, int ranks_per_node)
+    {
+        if (ranks_per_node <= 0)
+        {
+            throw exception("mpicxx::hierarchical_comm needs a positive ranks_per_node");
+        }
+        comm shared = parent.split_type(MPI_COMM_TYPE_SHARED, parent.rank());
+        node = shared.split(shared.rank() / ranks_per_node, parent.rank());
+        build(parent);
+    }
+
+    void hierarchical_comm::build(comm const &parent)
+    {
+        parent_rank = parent.rank();
+        parent_size = parent.size();
+        int node_rank = node.rank();
+        leaders = parent.split(node_rank == 0 ? 0 : MPI_UNDEFINED, parent_rank);
+
+        // Every rank learns (node index, rank within node) of every parent
+        // rank, from which the node-major slot of each rank follows.
+        int location[2] = {0, node_rank};
+        if (is_leader())
+        {
+            location[0] = leaders.rank();
+        }
+        handle_error(MPI_Bcast(&location[0], 1, MPI_INT, 0, node.get()));
+        std::vector<int> locations(2 * parent_size);
+        handle_error(
+            MPI_Allgather(
+                location,
+                2,
+                MPI_INT,
+                locations.data(),
+                2,
+                MPI_INT,
+                parent.get()));
+        int nodes = 0;
+        for (int p = 0; p < parent_size; ++p)
+        {
+            nodes = std::max(nodes, locations[2 * p] + 1);
+        }
+        node_sizes.assign(nodes, 0);
+        node_of_rank.resize(parent_size);
+        node_rank_of_rank.resize(parent_size);
+        for (int p = 0; p < parent_size; ++p)
+        {
+            node_of_rank[p] = locations[2 * p];
+            node_rank_of_rank[p] = locations[2 * p + 1];
+            ++node_sizes[node_of_rank[p]];
+        }
+        std::vector<int> node_offsets(nodes, 0);
+        for (int n = 1; n < nodes; ++n)
+        {
+            node_offsets[n] = node_offsets[n - 1] + node_sizes[n - 1];
+        }
+        slot_of_rank.resize(parent_size);
+        for (int p = 0; p < parent_size; ++p)
+        {
+            slot_of_rank[p] = node_offsets[node_of_rank[p]] + node_rank_of_rank[p];
+        }
+    }
+
+    void hierarchical_comm::node_barrier() const
+    {
+        contributions->barrier();
+    }
+
+    void hierarchical_comm::reserve(std::size_t contribution_bytes, std::size_t result_bytes)
+    {
+        bool leader = node.rank() == 0;
+        if (contributions && contributions->size() >= contribution_bytes &&
+            results->segment_size(0) >= result_bytes)
+        {
+            return;
+        }
+        if (contributions)
+        {
+            node_barrier();
+        }
+        results.reset();
+        contributions.reset();
+        contributions.reset(new shared_array<char>(node.dup(), contribution_bytes));
+        results.reset(new shared_array<char>(node.dup(), leader ? result_bytes : 0));
+    }
+
+    void hierarchical_comm::allreduce(void *buf, int count, datatype const &datatype_arg, op const &op_arg)
+    {
+        std::size_t extent = extent_of(datatype_arg);
+        std::size_t bytes = std::size_t(count) * extent;
+        reserve(bytes, bytes);
+        int node_rank = node.rank();
+        int local_size = node.size();
+        std::memcpy(contributions->data(), buf, bytes);
+        node_barrier();
+
+        // Each node rank reduces its own slice across all contributions,
+        // folding from the highest node rank down to keep operand order.
+        int slice = (count + local_size - 1) / local_size;
+        int lo = std::min(count, node_rank * slice);
+        int hi = std::min(count, lo + slice);
+        if (hi > lo)
+        {
+            std::size_t offset = std::size_t(lo) * extent;
+            std::size_t slice_bytes = std::size_t(hi - lo) * extent;
+            char *accumulator = results->segment(0) + offset;
+            std::memcpy(accumulator, contributions->segment(local_size - 1) + offset, slice_bytes);
+            for (int peer = local_size - 2; peer >= 0; --peer)
+            {
+                handle_error(
+                    MPI_Reduce_local(
+                        contributions->segment(peer) + offset,
+                        accumulator,
+                        hi - lo,
+                        datatype_arg.get(),
+                        op_arg.get()));
+            }
+        }
+        node_barrier();
+        if (is_leader() && leaders.size() > 1)
+        {
+            handle_error(
+                MPI_Allreduce(
+                    MPI_IN_PLACE,
+                    results->segment(0),
+                    count,
+                    datatype_arg.get(),
+                    op_arg.get(),
+                    leaders.get()));
+        }
+        node_barrier();
+        std::memcpy(buf, results->segment(0), bytes);
+    }
+
+    void hierarchical_comm::bcast(void *buf, int count, datatype const &datatype_arg, int root)
+    {
+        std::size_t bytes = std::size_t(count) * extent_of(datatype_arg);
+        reserve(bytes, bytes);
+        int root_node = node_of_rank[root];
+        if (parent_rank == root)
+        {
+            std::memcpy(contributions->data(), buf, bytes);
+        }
+        node_barrier();
+        if (is_leader())
+        {
+            if (leaders.rank() == root_node)
+            {
+                std::memcpy(results->segment(0), contributions->segment(node_rank_of_rank[root]), bytes);
+            }
+            if (leaders.size() > 1)
+            {
+                handle_error(
+                    MPI_Bcast(
+                        results->segment(0),
+                        count,
+                        datatype_arg.get(),
+                        root_node,
+                        leaders.get()));
+            }
+        }
+        node_barrier();
+        if (parent_rank != root)
+        {
+            std::memcpy(buf, results->segment(0), bytes);
+        }
+    }
+
+    void hierarchical_comm::gather(void const *sendbuf, int count, datatype const &datatype_arg, void *recvbuf, int root)
+    {
+        std::size_t bytes = std::size_t(count) * extent_of(datatype_arg);
+        reserve(bytes, bytes * parent_size);
+        std::memcpy(contributions->data(), sendbuf, bytes);
+        node_barrier();
+        if (is_leader())
+        {
+            std::vector<int> counts;
+            std::vector<int> displacements;
+            char *block = pack_node_block(count, bytes, counts, displacements);
+            bool root_leader = leaders.rank() == node_of_rank[root];
+            handle_error(
+                MPI_Gatherv(
+                    root_leader ? MPI_IN_PLACE : block,
+                    node.size() * count,
+                    datatype_arg.get(),
+                    results->segment(0),
+                    counts.data(),
+                    displacements.data(),
+                    datatype_arg.get(),
+                    node_of_rank[root],
+                    leaders.get()));
+        }
+        node_barrier();
+        if (parent_rank == root)
+        {
+            unpack_rank_order(recvbuf, bytes);
+        }
+    }
+
+    void hierarchical_comm::allgather(void const *sendbuf, int count, datatype const &datatype_arg, void *recvbuf)
+    {
+        std::size_t bytes = std::size_t(count) * extent_of(datatype_arg);
+        reserve(bytes, bytes * parent_size);
+        std::memcpy(contributions->data(), sendbuf, bytes);
+        node_barrier();
+        if (is_leader())
+        {
+            std::vector<int> counts;
+            std::vector<int> displacements;
+            pack_node_block(count, bytes, counts, displacements);
+            handle_error(
+                MPI_Allgatherv(
+                    MPI_IN_PLACE,
+                    0,
+                    MPI_DATATYPE_NULL,
+                    results->segment(0),
+                    counts.data(),
+                    displacements.data(),
+                    datatype_arg.get(),
+                    leaders.get()));
+        }
+        node_barrier();
+        unpack_rank_order(recvbuf, bytes);
+    }
+
+    char *hierarchical_comm::pack_node_block(
+        int count,
+        std::size_t bytes,
+        std::vector<int> &counts,
+        std::vector<int> &displacements)
+    {
+        // Segments may be larger than this call needs, so the node's
+        // contributions are copied into its slots of the result area.
+        counts.resize(node_sizes.size());
+        displacements.resize(node_sizes.size());
+        int displacement = 0;
+        int first_slot = 0;
+        for (std::size_t n = 0; n < node_sizes.size(); ++n)
+        {
+            if (int(n) < leaders.rank())
+            {
+                first_slot += node_sizes[n];
+            }
+            counts[n] = node_sizes[n] * count;
+            displacements[n] = displacement;
+            displacement += counts[n];
+        }
+        char *block = results->segment(0) + std::size_t(first_slot) * bytes;
+        for (int peer = 0; peer < node.size(); ++peer)
+        {
+            std::memcpy(block + std::size_t(peer) * bytes, contributions->segment(peer), bytes);
+        }
+        return block;
+    }
+
+    void hierarchical_comm::unpack_rank_order(void *recvbuf, std::size_t bytes) const
+    {
+        char *out = static_cast<char *>(recvbuf);
+        for (int p = 0; p < parent_size; ++p)
+        {
+            std::memcpy(out + std::size_t(p) * bytes, results->segment(0) + std::size_t(slot_of_rank[p]) * bytes, bytes);
+        }
+    }
+}
@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "instrumentation/instrumentation.hpp"
+
+#include "error/exception.hpp"
+#include "serialization/serialization.hpp"
+
+namespace mpicxx
+{
+    namespace details
+    {
+        namespace instrumentation
+        {
+            namespace
+            {
+                using key = std::tuple<std::string, std::string, int>;
+
+                std::mutex records_mutex;
+                std::map<key, std::unique_ptr<counters>> records;
+                thread_local counters *active = nullptr;
+                std::atomic<bool> reporting{false};
+
+                // 0 for empty messages, otherwise b such that the size lies
+                // in [2^(b-1), 2^b).
+                int bucket(std::size_t bytes)
+                {
+                    int result = 0;
+                    while (bytes != 0)
+                    {
+                        bytes >>= 1;
+                        ++result;
+                    }
+                    return result;
+                }
+
+                std::uint64_t nanoseconds(double seconds)
+                {
+                    return std::uint64_t(seconds * 1e9);
+                }
+
+                counters *lookup(MPI_Comm comm, char const *operation, std::size_t bytes)
+                {
+                    char name[MPI_MAX_OBJECT_NAME];
+                    int length = 0;
+                    handle_error(MPI_Comm_get_name(comm, name, &length));
+                    key k(std::string(name, std::size_t(length)), operation, bucket(bytes));
+                    std::lock_guard<std::mutex> lock(records_mutex);
+                    std::unique_ptr<counters> &record = records[k];
+                    if (!record)
+                    {
+                        record.reset(new counters);
+                    }
+                    return record.get();
+                }
+
+                std::string escape(std::string const &text)
+                {
+                    std::string result;
+                    for (char c : text)
+                    {
+                        if (c == '"' || c == '\\')
+                        {
+                            result += '\\';
+                        }
+                        result += c;
+                    }
+                    return result;
+                }
+            }
+
+            counters *current()
+            {
+                return active;
+            }
+
+            void add_wait(counters *record, double seconds)
+            {
+                record->wait_nanoseconds += nanoseconds(seconds);
+            }
+
+            std::size_t total(int const counts[], int count)
+            {
+                std::size_t result = 0;
+                for (int i = 0; counts && i < count; ++i)
+                {
+                    result += std::size_t(counts[i]);
+                }
+                return result;
+            }
+
+            scope::scope(MPI_Comm comm, char const *operation, std::size_t count, MPI_Datatype datatype)
+            {
+                if (active || reporting)
+                {
+                    return;
+                }
+                int size = 0;
+                if (count != 0)
+                {
+                    handle_error(MPI_Type_size(datatype, &size));
+                }
+                std::size_t bytes = count * std::size_t(size);
+                record = lookup(comm, operation, bytes);
+                record->calls += 1;
+                record->bytes += bytes;
+                active = record;
+                start = MPI_Wtime();
+            }
+
+            scope::~scope()
+            {
+                if (record)
+                {
+                    record->initiation_nanoseconds += nanoseconds(MPI_Wtime() - start);
+                    active = nullptr;
+                }
+            }
+
+            void report()
+            {
+                reporting = true;
+                using entry = std::pair<std::string, std::array<std::uint64_t, 5>>;
+                std::vector<entry> local;
+                {
+                    std::lock_guard<std::mutex> lock(records_mutex);
+                    for (auto const &record : records)
+                    {
+                        std::string label = std::get<0>(record.first) + '\n' + std::get<1>(record.first) + '\n' + std::to_string(std::get<2>(record.first));
+                        local.emplace_back(
+                            std::move(label),
+                            std::array<std::uint64_t, 5>{
+                                record.second->calls.load(),
+                                record.second->bytes.load(),
+                                record.second->initiation_nanoseconds.load(),
+                                record.second->wait_nanoseconds.load(),
+                                record.second->wait_nanoseconds.load()});
+                    }
+                }
+                std::vector<char> packed = pack(local);
+                int rank, size;
+                handle_error(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+                handle_error(MPI_Comm_size(MPI_COMM_WORLD, &size));
+                int packed_size = int(packed.size());
+                std::vector<int> sizes(rank == 0 ? size : 0);
+                handle_error(MPI_Gather(&packed_size, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0, MPI_COMM_WORLD));
+                std::vector<int> displacements(sizes.size());
+                std::size_t total_size = 0;
+                for (std::size_t i = 0; i < sizes.size(); ++i)
+                {
+                    displacements[i] = int(total_size);
+                    total_size += std::size_t(sizes[i]);
+                }
+                std::vector<char> gathered(total_size);
+                handle_error(
+                    MPI_Gatherv(
+                        packed.data(),
+                        packed_size,
+                        MPI_BYTE,
+                        gathered.data(),
+                        sizes.data(),
+                        displacements.data(),
+                        MPI_BYTE,
+                        0,
+                        MPI_COMM_WORLD));
+                if (rank != 0)
+                {
+                    return;
+                }
+
+                // calls, bytes, initiation, wait summed; max wait on one rank;
+                // number of ranks that used the bucket.
+                std::map<std::string, std::array<std::uint64_t, 6>> merged;
+                for (int r = 0; r < size; ++r)
+                {
+                    std::vector<entry> remote;
+                    unpack(gathered.data() + displacements[r], std::size_t(sizes[r]), remote);
+                    for (entry const &item : remote)
+                    {
+                        std::array<std::uint64_t, 6> &sum = merged[item.first];
+                        for (int i = 0; i < 4; ++i)
+                        {
+                            sum[i] += item.second[i];
+                        }
+                        sum[4] = std::max(sum[4], item.second[4]);
+                        sum[5] += 1;
+                    }
+                }
+
+                char const *path = std::getenv("MPICXX_INSTRUMENTATION_FILE");
+                std::FILE *out = std::fopen(path ? path : "mpicxx_instrumentation.json", "w");
+                if (!out)
+                {
+                    return;
+                }
+                std::fprintf(out, "{\n  \"ranks\": %d,\n  \"records\": [", size);
+                bool first = true;
+                for (auto const &item : merged)
+                {
+                    std::size_t split1 = item.first.find('\n');
+                    std::size_t split2 = item.first.find('\n', split1 + 1);
+                    int b = std::atoi(item.first.c_str() + split2 + 1);
+                    std::uint64_t min_bytes = b == 0 ? 0 : std::uint64_t(1) << (b - 1);
+                    std::fprintf(
+                        out,
+                        "%s\n    {\"communicator\": \"%s\", \"operation\": \"%s\", \"min_bytes\": %llu, "
+                        "\"calls\": %llu, \"bytes\": %llu, \"initiation_seconds\": %.9f, "
+                        "\"wait_seconds\": %.9f, \"max_rank_wait_seconds\": %.9f, \"ranks\": %llu}",
+                        first ? "" : ",",
+                        escape(item.first.substr(0, split1)).c_str(),
+                        escape(item.first.substr(split1 + 1, split2 - split1 - 1)).c_str(),
+                        (unsigned long long)min_bytes,
+                        (unsigned long long)item.second[0],
+                        (unsigned long long)item.second[1],
+                        item.second[2] * 1e-9,
+                        item.second[3] * 1e-9,
+                        item.second[4] * 1e-9,
+                        (unsigned long long)item.second[5]);
+                    first = false;
+                }
+                std::fprintf(out, "\n  ]\n}\n");
+                std::fclose(out);
+            }
+        }
+    }
+}
@@ -0,0 +1,127 @@
+#include <utility>
+
+#include "error/exception.hpp"
+#include "handles/partitioned_request.hpp"
+
+namespace mpicxx
+{
+    partitioned_request &partitioned_request::operator=(partitioned_request &&other)
+    {
+        free();
+#if MPI_VERSION >= 4
+        implementation = other.implementation;
+        other.implementation = MPI_REQUEST_NULL;
+#else
+        implementations = std::move(other.implementations);
+        receiving = other.receiving;
+        other.implementations.clear();
+#endif
+        return *this;
+    }
+
+    partitioned_request::~partitioned_request()
+    {
+        free();
+    }
+
+    void partitioned_request::free()
+    {
+#if MPI_VERSION >= 4
+        if (implementation != MPI_REQUEST_NULL)
+        {
+            wait();
+            handle_error(MPI_Request_free(&implementation));
+        }
+#else
+        wait();
+        for (MPI_Request &implementation : implementations)
+        {
+            handle_error(MPI_Request_free(&implementation));
+        }
+        implementations.clear();
+#endif
+    }
+
+    void partitioned_request::start()
+    {
+#if MPI_VERSION >= 4
+        handle_error(MPI_Start(&implementation));
+#else
+        // Sends start partition by partition from pready().
+        if (receiving)
+        {
+            handle_error(
+                MPI_Startall(
+                    int(implementations.size()),
+                    implementations.data()));
+        }
+#endif
+    }
+
+    void partitioned_request::pready(int partition)
+    {
+#if MPI_VERSION >= 4
+        handle_error(MPI_Pready(partition, implementation));
+#else
+        handle_error(MPI_Start(&implementations[partition]));
+#endif
+    }
+
+    void partitioned_request::pready_range(int partition_low, int partition_high)
+    {
+#if MPI_VERSION >= 4
+        handle_error(MPI_Pready_range(partition_low, partition_high, implementation));
+#else
+        handle_error(
+            MPI_Startall(
+                partition_high - partition_low + 1,
+                implementations.data() + partition_low));
+#endif
+    }
+
+    bool partitioned_request::parrived(int partition)
+    {
+        int flag;
+#if MPI_VERSION >= 4
+        handle_error(MPI_Parrived(implementation, partition, &flag));
+#else
+        handle_error(MPI_Test(&implementations[partition], &flag, MPI_STATUS_IGNORE));
+#endif
+        return bool(flag);
+    }
+
+    void partitioned_request::wait()
+    {
+#if MPI_VERSION >= 4
+        if (implementation != MPI_REQUEST_NULL)
+        {
+            handle_error(MPI_Wait(&implementation, MPI_STATUS_IGNORE));
+        }
+#else
+        handle_error(
+            MPI_Waitall(
+                int(implementations.size()),
+                implementations.data(),
+                MPI_STATUSES_IGNORE));
+#endif
+    }
+
+    bool partitioned_request::test()
+    {
+        int flag = 1;
+#if MPI_VERSION >= 4
+        if (implementation != MPI_REQUEST_NULL)
+        {
+            handle_error(MPI_Test(&implementation, &flag, MPI_STATUS_IGNORE));
+        }
+#else
+        handle_error(
+            MPI_Testall(
+                int(implementations.size()),
+                implementations.data(),
+                &flag,
+                MPI_STATUSES_IGNORE));
+#endif
+        return bool(flag);
+    }
+}
@@ -1,3 +1,6 @@
+#include <mutex>
+#include <vector>
+
 #include "reductionoperation/reductionop.hpp"
 #include "error/exception.hpp"
 
@@ -56,4 +59,29 @@ namespace mpicxx
         return op(implementation);
     }
 
+    namespace details
+    {
+        namespace
+        {
+            std::mutex cached_ops_mutex;
+            std::vector<MPI_Op> cached_ops;
+        }
+
+        void register_cached_op(MPI_Op implementation)
+        {
+            std::lock_guard<std::mutex> lock(cached_ops_mutex);
+            cached_ops.push_back(implementation);
+        }
+
+        void free_cached_ops()
+        {
+            std::lock_guard<std::mutex> lock(cached_ops_mutex);
+            for (MPI_Op &implementation : cached_ops)
+            {
+                handle_error(MPI_Op_free(&implementation));
+            }
+            cached_ops.clear();
+        }
+    }
+
 } // namespace mpicxx
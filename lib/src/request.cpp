@@ -1,10 +1,127 @@
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include "error/exception.hpp"
+#include "handles/completion_queue.hpp"
 #include "handles/request.hpp"
 
 namespace mpicxx
 {
+    namespace
+    {
+#ifdef MPICXX_ENABLE_INSTRUMENTATION
+        class wait_timer
+        {
+            details::instrumentation::counters *record;
+            double start;
+
+        public:
+            explicit wait_timer(details::instrumentation::counters *record_arg)
+                : record(record_arg), start(record_arg ? MPI_Wtime() : 0.0)
+            {
+            }
+            ~wait_timer()
+            {
+                if (record)
+                {
+                    details::instrumentation::add_wait(record, MPI_Wtime() - start);
+                }
+            }
+        };
+#define MPICXX_TIME_WAIT(record) wait_timer mpicxx_wait_timer(record)
+#else
+#define MPICXX_TIME_WAIT(record) ((void)0)
+#endif
+
+#ifdef MPICXX_ENABLE_TRACING
+        thread_local bool implicit_wait = false;
+
+        // Marks waits issued by ~request and assignment, which callers do
+        // not see in their own code.
+        class implicit_wait_scope
+        {
+            bool previous;
+
+        public:
+            implicit_wait_scope()
+                : previous(implicit_wait)
+            {
+                implicit_wait = true;
+            }
+            ~implicit_wait_scope()
+            {
+                implicit_wait = previous;
+            }
+        };
+#define MPICXX_TRACE_IMPLICIT_WAIT() implicit_wait_scope mpicxx_implicit_wait_scope
+#define MPICXX_TRACE_WAIT_BEGIN()                                                \
+    bool traced = implementation != MPI_REQUEST_NULL;                            \
+    if (traced)                                                                  \
+    {                                                                            \
+        trace(implicit_wait ? details::tracing::event_kind::implicit_wait_begin  \
+                            : details::tracing::event_kind::wait_begin);         \
+    }
+#define MPICXX_TRACE_WAIT_END()                                                  \
+    if (traced)                                                                  \
+    {                                                                            \
+        trace(details::tracing::event_kind::wait_end);                           \
+        trace(details::tracing::event_kind::complete);                           \
+    }
+#define MPICXX_TRACE_TEST_BEGIN()                                                \
+    bool traced = implementation != MPI_REQUEST_NULL;                            \
+    if (traced)                                                                  \
+    {                                                                            \
+        trace(details::tracing::event_kind::test);                               \
+    }
+#define MPICXX_TRACE_TEST_END()                                                  \
+    if (traced && implementation == MPI_REQUEST_NULL)                            \
+    {                                                                            \
+        trace(details::tracing::event_kind::complete);                           \
+    }
+#else
+#define MPICXX_TRACE_IMPLICIT_WAIT() ((void)0)
+#define MPICXX_TRACE_WAIT_BEGIN() ((void)0)
+#define MPICXX_TRACE_WAIT_END() ((void)0)
+#define MPICXX_TRACE_TEST_BEGIN() ((void)0)
+#define MPICXX_TRACE_TEST_END() ((void)0)
+#endif
+    }
+
+#ifdef MPICXX_ENABLE_TRACING
+    void request::trace_create()
+    {
+        if (implementation != MPI_REQUEST_NULL || continuation)
+        {
+            trace_id = details::tracing::next_id();
+            trace_name = details::tracing::current_operation ? details::tracing::current_operation : "request";
+            trace(details::tracing::event_kind::create);
+        }
+    }
+
+    void request::trace(details::tracing::event_kind kind) const
+    {
+        if (trace_id != 0)
+        {
+            details::tracing::record(kind, trace_id, trace_name);
+        }
+    }
+#endif
+
+    request::request(
+        MPI_Request implementation_arg,
+        std::unique_ptr<details::request_continuation> continuation_arg)
+        : implementation(implementation_arg), continuation(std::move(continuation_arg))
+    {
+#ifdef MPICXX_ENABLE_TRACING
+        trace_create();
+#endif
+        if (implementation == MPI_REQUEST_NULL)
+        {
+            advance();
+        }
+    }
+
     request::request(request const &other)
     {
         if (other.implementation != MPI_REQUEST_NULL)
@@ -20,65 +137,281 @@ namespace mpicxx
         {
             throw exception("tried to copy assign from a non-null mpicxx::request object");
         }
-        wait();
+        {
+            MPICXX_TRACE_IMPLICIT_WAIT();
+            wait();
+        }
         implementation = other.implementation;
         return *this;
     }
 
     request &request::operator=(request &&other)
     {
-        wait();
+        {
+            MPICXX_TRACE_IMPLICIT_WAIT();
+            wait();
+        }
         implementation = other.implementation;
+        continuation = std::move(other.continuation);
         other.implementation = MPI_REQUEST_NULL;
+#ifdef MPICXX_ENABLE_INSTRUMENTATION
+        instrumented = other.instrumented;
+#endif
+#ifdef MPICXX_ENABLE_TRACING
+        trace_id = other.trace_id;
+        trace_name = other.trace_name;
+#endif
         return *this;
     }
 
+    void request::advance()
+    {
+        if (continuation && continuation->complete(implementation))
+        {
+            continuation.reset();
+        }
+    }
+
     void request::wait()
     {
         if (implementation != MPI_REQUEST_NULL)
+        {
+            details::reap_detached();
+        }
+        MPICXX_TIME_WAIT(implementation != MPI_REQUEST_NULL ? instrumented : nullptr);
+        MPICXX_TRACE_WAIT_BEGIN();
+        while (implementation != MPI_REQUEST_NULL)
         {
             handle_error(MPI_Wait(&implementation, MPI_STATUS_IGNORE));
+            advance();
         }
+        MPICXX_TRACE_WAIT_END();
     }
 
     bool request::test()
     {
-        int flag = 1;
         if (implementation != MPI_REQUEST_NULL)
+        {
+            details::reap_detached();
+        }
+        MPICXX_TIME_WAIT(implementation != MPI_REQUEST_NULL ? instrumented : nullptr);
+        MPICXX_TRACE_TEST_BEGIN();
+        int flag = 1;
+        while (implementation != MPI_REQUEST_NULL)
         {
             handle_error(MPI_Test(&implementation, &flag, MPI_STATUS_IGNORE));
+            if (!flag)
+            {
+                break;
+            }
+            advance();
         }
+        MPICXX_TRACE_TEST_END();
         return bool(flag);
     }
 
     void request::wait(status &status_arg)
     {
         if (implementation != MPI_REQUEST_NULL)
+        {
+            details::reap_detached();
+        }
+        MPICXX_TIME_WAIT(implementation != MPI_REQUEST_NULL ? instrumented : nullptr);
+        MPICXX_TRACE_WAIT_BEGIN();
+        while (implementation != MPI_REQUEST_NULL)
         {
             MPI_Status status_implementation;
             handle_error(MPI_Wait(&implementation, &status_implementation));
             status_arg = status(status_implementation);
+            advance();
         }
+        MPICXX_TRACE_WAIT_END();
     }
 
     bool request::test(status &status_arg)
     {
-        int flag = 1;
         if (implementation != MPI_REQUEST_NULL)
+        {
+            details::reap_detached();
+        }
+        MPICXX_TIME_WAIT(implementation != MPI_REQUEST_NULL ? instrumented : nullptr);
+        MPICXX_TRACE_TEST_BEGIN();
+        int flag = 1;
+        while (implementation != MPI_REQUEST_NULL)
         {
             MPI_Status status_implementation;
             handle_error(MPI_Test(&implementation, &flag, &status_implementation));
+            if (!flag)
+            {
+                break;
+            }
             status_arg = status(status_implementation);
+            advance();
         }
+        MPICXX_TRACE_TEST_END();
         return bool(flag);
     }
 
     request::~request()
     {
+        MPICXX_TRACE_IMPLICIT_WAIT();
         wait();
     }
 
+    MPI_Request request::release()
+    {
+        if (continuation)
+        {
+            throw exception("tried to release an mpicxx::request whose operation has further phases");
+        }
+        MPI_Request result = implementation;
+        implementation = MPI_REQUEST_NULL;
+        return result;
+    }
+
+    void request::then(std::function<void(status const &)> callback)
+    {
+        completion_queue::local().push(std::move(*this), std::move(callback));
+    }
+
+    void request::detach()
+    {
+        details::detach(std::move(*this), [](status const &) {});
+    }
+
+    void request::detach(std::function<void(status const &)> callback)
+    {
+        details::detach(std::move(*this), std::move(callback));
+    }
+
     void waitall(int count, request *array_of_requests)
+    {
+        std::vector<MPI_Request> array_of_implementations(count);
+        for (int i = 0; i < count; ++i)
+        {
+            array_of_implementations[i] = array_of_requests[i].get();
+        }
+#ifdef MPICXX_ENABLE_INSTRUMENTATION
+        double start = MPI_Wtime();
+#endif
+#ifdef MPICXX_ENABLE_TRACING
+        details::tracing::record(details::tracing::event_kind::wait_begin, 0, "waitall");
+#endif
+        handle_error(
+            MPI_Waitall(
+                count,
+                array_of_implementations.data(),
+                MPI_STATUSES_IGNORE));
+#ifdef MPICXX_ENABLE_INSTRUMENTATION
+        // The elapsed time is shared evenly by the instrumented requests.
+        double elapsed = MPI_Wtime() - start;
+        int instrumented = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            instrumented += array_of_requests[i].get() != MPI_REQUEST_NULL && array_of_requests[i].instrumented;
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            if (array_of_requests[i].get() != MPI_REQUEST_NULL && array_of_requests[i].instrumented)
+            {
+                details::instrumentation::add_wait(array_of_requests[i].instrumented, elapsed / instrumented);
+            }
+        }
+#endif
+#ifdef MPICXX_ENABLE_TRACING
+        details::tracing::record(details::tracing::event_kind::wait_end, 0, "waitall");
+        for (int i = 0; i < count; ++i)
+        {
+            if (array_of_requests[i].get() != MPI_REQUEST_NULL)
+            {
+                array_of_requests[i].trace(details::tracing::event_kind::complete);
+            }
+        }
+#endif
+        for (int i = 0; i < count; ++i)
+        {
+            array_of_requests[i].get() = array_of_implementations[i];
+            array_of_requests[i].advance();
+            array_of_requests[i].wait();
+        }
+    }
+
+    persistent_request &persistent_request::operator=(persistent_request &&other)
+    {
+        if (implementation != MPI_REQUEST_NULL)
+        {
+            wait();
+            handle_error(MPI_Request_free(&implementation));
+        }
+        implementation = other.implementation;
+        other.implementation = MPI_REQUEST_NULL;
+        return *this;
+    }
+
+    void persistent_request::start()
+    {
+        handle_error(MPI_Start(&implementation));
+    }
+
+    void persistent_request::wait()
+    {
+        if (implementation != MPI_REQUEST_NULL)
+        {
+            handle_error(MPI_Wait(&implementation, MPI_STATUS_IGNORE));
+        }
+    }
+
+    bool persistent_request::test()
+    {
+        int flag = 1;
+        if (implementation != MPI_REQUEST_NULL)
+        {
+            handle_error(MPI_Test(&implementation, &flag, MPI_STATUS_IGNORE));
+        }
+        return bool(flag);
+    }
+
+    void persistent_request::wait(status &status_arg)
+    {
+        if (implementation != MPI_REQUEST_NULL)
+        {
+            MPI_Status status_implementation;
+            handle_error(MPI_Wait(&implementation, &status_implementation));
+            status_arg = status(status_implementation);
+        }
+    }
+
+    bool persistent_request::test(status &status_arg)
+    {
+        int flag = 1;
+        if (implementation != MPI_REQUEST_NULL)
+        {
+            MPI_Status status_implementation;
+            handle_error(MPI_Test(&implementation, &flag, &status_implementation));
+            status_arg = status(status_implementation);
+        }
+        return bool(flag);
+    }
+
+    persistent_request::~persistent_request()
+    {
+        if (implementation != MPI_REQUEST_NULL)
+        {
+            wait();
+            handle_error(MPI_Request_free(&implementation));
+        }
+    }
+
+    void startall(int count, persistent_request *array_of_requests)
+    {
+        MPI_Request *array_of_implementations = &(array_of_requests->get());
+        handle_error(
+            MPI_Startall(
+                count,
+                array_of_implementations));
+    }
+
+    void waitall(int count, persistent_request *array_of_requests)
     {
         MPI_Request *array_of_implementations = &(array_of_requests->get());
         handle_error(
@@ -88,4 +421,4 @@ namespace mpicxx
                 MPI_STATUSES_IGNORE));
     }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <utility>
+
+#include "error/exception.hpp"
+#include "handles/request_set.hpp"
+
+namespace mpicxx
+{
+    request_set::request_set(request_set &&other) noexcept
+        : implementations(std::move(other.implementations)),
+          continuations(std::move(other.continuations)),
+          status_implementations(std::move(other.status_implementations)),
+          pending_continuations(other.pending_continuations)
+    {
+        other.implementations.clear();
+        other.continuations.clear();
+        other.pending_continuations = 0;
+    }
+
+    request_set &request_set::operator=(request_set &&other)
+    {
+        wait_all();
+        implementations = std::move(other.implementations);
+        continuations = std::move(other.continuations);
+        status_implementations = std::move(other.status_implementations);
+        pending_continuations = other.pending_continuations;
+        other.implementations.clear();
+        other.continuations.clear();
+        other.pending_continuations = 0;
+        return *this;
+    }
+
+    request_set::~request_set()
+    {
+        wait_all();
+    }
+
+    std::size_t request_set::insert(request &&request_arg)
+    {
+        implementations.push_back(request_arg.implementation);
+        continuations.push_back(std::move(request_arg.continuation));
+        request_arg.implementation = MPI_REQUEST_NULL;
+        if (continuations.back())
+        {
+            ++pending_continuations;
+        }
+        return implementations.size() - 1;
+    }
+
+    request request_set::release(std::size_t index)
+    {
+        MPI_Request result = implementations[index];
+        implementations[index] = MPI_REQUEST_NULL;
+        if (continuations[index])
+        {
+            --pending_continuations;
+        }
+        return request(result, std::move(continuations[index]));
+    }
+
+    void request_set::compact()
+    {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < implementations.size(); ++i)
+        {
+            if (implementations[i] != MPI_REQUEST_NULL)
+            {
+                implementations[kept] = implementations[i];
+                continuations[kept] = std::move(continuations[i]);
+                ++kept;
+            }
+        }
+        implementations.resize(kept);
+        continuations.resize(kept);
+    }
+
+    bool request_set::finish(std::size_t index)
+    {
+        std::unique_ptr<details::request_continuation> &continuation = continuations[index];
+        if (!continuation)
+        {
+            return true;
+        }
+        if (!continuation->complete(implementations[index]))
+        {
+            return false;
+        }
+        continuation.reset();
+        --pending_continuations;
+        return true;
+    }
+
+    void request_set::drop_unfinished(std::vector<int> &indices, std::vector<MPI_Status> *statuses)
+    {
+        if (pending_continuations == 0)
+        {
+            return;
+        }
+        std::size_t kept = 0;
+        for (std::size_t k = 0; k < indices.size(); ++k)
+        {
+            if (finish(indices[k]))
+            {
+                indices[kept] = indices[k];
+                if (statuses)
+                {
+                    (*statuses)[kept] = (*statuses)[k];
+                }
+                ++kept;
+            }
+        }
+        indices.resize(kept);
+    }
+
+    int request_set::wait_any()
+    {
+        int index;
+        do
+        {
+            handle_error(
+                MPI_Waitany(
+                    int(implementations.size()),
+                    implementations.data(),
+                    &index,
+                    MPI_STATUS_IGNORE));
+        } while (index != MPI_UNDEFINED && !finish(index));
+        return index;
+    }
+
+    int request_set::wait_any(status &status_arg)
+    {
+        int index;
+        MPI_Status status_implementation;
+        do
+        {
+            handle_error(
+                MPI_Waitany(
+                    int(implementations.size()),
+                    implementations.data(),
+                    &index,
+                    &status_implementation));
+        } while (index != MPI_UNDEFINED && !finish(index));
+        if (index != MPI_UNDEFINED)
+        {
+            status_arg = status(status_implementation);
+        }
+        return index;
+    }
+
+    void request_set::wait_some(std::vector<int> &indices)
+    {
+        do
+        {
+            int outcount;
+            indices.resize(implementations.size());
+            handle_error(
+                MPI_Waitsome(
+                    int(implementations.size()),
+                    implementations.data(),
+                    &outcount,
+                    indices.data(),
+                    MPI_STATUSES_IGNORE));
+            if (outcount == MPI_UNDEFINED)
+            {
+                indices.clear();
+                return;
+            }
+            indices.resize(outcount);
+            drop_unfinished(indices, nullptr);
+        } while (indices.empty());
+    }
+
+    void request_set::wait_some(std::vector<int> &indices, std::vector<status> &statuses)
+    {
+        do
+        {
+            int outcount;
+            indices.resize(implementations.size());
+            status_implementations.resize(implementations.size());
+            handle_error(
+                MPI_Waitsome(
+                    int(implementations.size()),
+                    implementations.data(),
+                    &outcount,
+                    indices.data(),
+                    status_implementations.data()));
+            if (outcount == MPI_UNDEFINED)
+            {
+                indices.clear();
+                statuses.clear();
+                return;
+            }
+            indices.resize(outcount);
+            drop_unfinished(indices, &status_implementations);
+        } while (indices.empty());
+        statuses.assign(status_implementations.begin(), status_implementations.begin() + indices.size());
+    }
+
+    void request_set::test_some(std::vector<int> &indices)
+    {
+        int outcount;
+        indices.resize(implementations.size());
+        handle_error(
+            MPI_Testsome(
+                int(implementations.size()),
+                implementations.data(),
+                &outcount,
+                indices.data(),
+                MPI_STATUSES_IGNORE));
+        indices.resize(outcount == MPI_UNDEFINED ? 0 : outcount);
+        drop_unfinished(indices, nullptr);
+    }
+
+    void request_set::test_some(std::vector<int> &indices, std::vector<status> &statuses)
+    {
+        int outcount;
+        indices.resize(implementations.size());
+        status_implementations.resize(implementations.size());
+        handle_error(
+            MPI_Testsome(
+                int(implementations.size()),
+                implementations.data(),
+                &outcount,
+                indices.data(),
+                status_implementations.data()));
+        indices.resize(outcount == MPI_UNDEFINED ? 0 : outcount);
+        drop_unfinished(indices, &status_implementations);
+        statuses.assign(status_implementations.begin(), status_implementations.begin() + indices.size());
+    }
+
+    bool request_set::test_all()
+    {
+        int flag;
+        handle_error(
+            MPI_Testall(
+                int(implementations.size()),
+                implementations.data(),
+                &flag,
+                MPI_STATUSES_IGNORE));
+        if (flag && pending_continuations != 0)
+        {
+            for (std::size_t i = 0; i < continuations.size(); ++i)
+            {
+                flag = finish(i) && flag;
+            }
+        }
+        return bool(flag);
+    }
+
+    bool request_set::test_all(std::vector<status> &statuses)
+    {
+        int flag;
+        status_implementations.resize(implementations.size());
+        handle_error(
+            MPI_Testall(
+                int(implementations.size()),
+                implementations.data(),
+                &flag,
+                status_implementations.data()));
+        if (flag && pending_continuations != 0)
+        {
+            for (std::size_t i = 0; i < continuations.size(); ++i)
+            {
+                flag = finish(i) && flag;
+            }
+        }
+        if (flag)
+        {
+            statuses.assign(status_implementations.begin(), status_implementations.end());
+        }
+        return bool(flag);
+    }
+
+    void request_set::wait_all()
+    {
+        do
+        {
+            if (implementations.empty())
+            {
+                return;
+            }
+            handle_error(
+                MPI_Waitall(
+                    int(implementations.size()),
+                    implementations.data(),
+                    MPI_STATUSES_IGNORE));
+            for (std::size_t i = 0; pending_continuations != 0 && i < continuations.size(); ++i)
+            {
+                finish(i);
+            }
+        } while (pending_continuations != 0);
+    }
+}
@@ -0,0 +1,208 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+#include "instrumentation/tracing.hpp"
+
+#include "error/exception.hpp"
+
+namespace mpicxx
+{
+    namespace details
+    {
+        namespace tracing
+        {
+            namespace
+            {
+                std::size_t const ring_capacity = std::size_t(1) << 16;
+                int const offset_rounds = 16;
+
+                struct event
+                {
+                    double time;
+                    std::uint64_t id;
+                    char const *name;
+                    event_kind kind;
+                };
+
+                // Written only by its own thread; read at finalize once the
+                // other threads have stopped issuing MPI calls. When full, the
+                // oldest events are overwritten.
+                struct ring
+                {
+                    std::vector<event> events = std::vector<event>(ring_capacity);
+                    std::uint64_t recorded = 0;
+                };
+
+                std::mutex rings_mutex;
+                std::vector<std::shared_ptr<ring>> rings;
+                std::atomic<std::uint64_t> ids{0};
+                bool started = false;
+                double clock_offset = 0.0;
+
+                ring &local_ring()
+                {
+                    thread_local std::shared_ptr<ring> local = []
+                    {
+                        auto created = std::make_shared<ring>();
+                        std::lock_guard<std::mutex> lock(rings_mutex);
+                        rings.push_back(created);
+                        return created;
+                    }();
+                    return *local;
+                }
+
+                // Offset of this rank's MPI_Wtime from rank 0's, from the
+                // ping-pong round with the smallest round-trip time.
+                double estimate_offset(int rank, int size)
+                {
+                    int *is_global = nullptr;
+                    int flag = 0;
+                    handle_error(MPI_Comm_get_attr(MPI_COMM_WORLD, MPI_WTIME_IS_GLOBAL, &is_global, &flag));
+                    if (flag && is_global && *is_global)
+                    {
+                        return 0.0;
+                    }
+                    double result = 0.0;
+                    for (int peer = 1; peer < size; ++peer)
+                    {
+                        if (rank == 0)
+                        {
+                            double best = -1.0;
+                            double offset = 0.0;
+                            for (int round = 0; round < offset_rounds; ++round)
+                            {
+                                double remote;
+                                double sent = MPI_Wtime();
+                                handle_error(MPI_Send(&sent, 1, MPI_DOUBLE, peer, 0, MPI_COMM_WORLD));
+                                handle_error(MPI_Recv(&remote, 1, MPI_DOUBLE, peer, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE));
+                                double received = MPI_Wtime();
+                                if (best < 0.0 || received - sent < best)
+                                {
+                                    best = received - sent;
+                                    offset = remote - (sent + received) / 2;
+                                }
+                            }
+                            handle_error(MPI_Send(&offset, 1, MPI_DOUBLE, peer, 0, MPI_COMM_WORLD));
+                        }
+                        else if (rank == peer)
+                        {
+                            for (int round = 0; round < offset_rounds; ++round)
+                            {
+                                double ping;
+                                handle_error(MPI_Recv(&ping, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE));
+                                double now = MPI_Wtime();
+                                handle_error(MPI_Send(&now, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD));
+                            }
+                            handle_error(MPI_Recv(&result, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE));
+                        }
+                    }
+                    return result;
+                }
+
+                std::string escape(char const *text)
+                {
+                    std::string result;
+                    for (; *text; ++text)
+                    {
+                        if (*text == '"' || *text == '\\')
+                        {
+                            result += '\\';
+                        }
+                        result += *text;
+                    }
+                    return result;
+                }
+            }
+
+            std::uint64_t next_id()
+            {
+                return ++ids;
+            }
+
+            void record(event_kind kind, std::uint64_t id, char const *name)
+            {
+                ring &local = local_ring();
+                local.events[local.recorded % ring_capacity] = event{MPI_Wtime(), id, name, kind};
+                ++local.recorded;
+            }
+
+            void start()
+            {
+                if (started)
+                {
+                    return;
+                }
+                started = true;
+                int rank, size;
+                handle_error(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+                handle_error(MPI_Comm_size(MPI_COMM_WORLD, &size));
+                clock_offset = estimate_offset(rank, size);
+                // Rank 0's start time becomes timestamp zero on every rank.
+                double base = MPI_Wtime();
+                handle_error(MPI_Bcast(&base, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD));
+                clock_offset += base;
+            }
+
+            void finish()
+            {
+                if (!started)
+                {
+                    return;
+                }
+                int rank;
+                handle_error(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+                char const *prefix = std::getenv("MPICXX_TRACE_PREFIX");
+                std::string path = std::string(prefix ? prefix : "mpicxx_trace") + '.' + std::to_string(rank) + ".json";
+                std::FILE *out = std::fopen(path.c_str(), "w");
+                if (!out)
+                {
+                    return;
+                }
+                std::fprintf(out, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+                std::fprintf(out, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"args\": {\"name\": \"rank %d\"}}", rank, rank);
+                std::lock_guard<std::mutex> lock(rings_mutex);
+                for (std::size_t thread = 0; thread < rings.size(); ++thread)
+                {
+                    ring const &events = *rings[thread];
+                    std::uint64_t first = events.recorded > ring_capacity ? events.recorded - ring_capacity : 0;
+                    for (std::uint64_t i = first; i < events.recorded; ++i)
+                    {
+                        event const &e = events.events[i % ring_capacity];
+                        double ts = (e.time - clock_offset) * 1e6;
+                        std::string name = escape(e.name);
+                        switch (e.kind)
+                        {
+                        case event_kind::create:
+                        case event_kind::complete:
+                            std::fprintf(out, ",\n{\"name\": \"%s\", \"cat\": \"request\", \"ph\": \"%s\", \"id\": %llu, \"pid\": %d, \"tid\": %zu, \"ts\": %.3f}",
+                                         name.c_str(), e.kind == event_kind::create ? "b" : "e", (unsigned long long)e.id, rank, thread, ts);
+                            break;
+                        case event_kind::test:
+                            std::fprintf(out, ",\n{\"name\": \"test\", \"cat\": \"request\", \"ph\": \"n\", \"id\": %llu, \"pid\": %d, \"tid\": %zu, \"ts\": %.3f}",
+                                         (unsigned long long)e.id, rank, thread, ts);
+                            break;
+                        case event_kind::wait_begin:
+                        case event_kind::implicit_wait_begin:
+                            std::fprintf(out, ",\n{\"name\": \"%s %s\", \"cat\": \"wait\", \"ph\": \"B\", \"pid\": %d, \"tid\": %zu, \"ts\": %.3f, \"args\": {\"request\": %llu}}",
+                                         e.kind == event_kind::wait_begin ? "wait" : "implicit wait", name.c_str(), rank, thread, ts, (unsigned long long)e.id);
+                            break;
+                        case event_kind::wait_end:
+                            std::fprintf(out, ",\n{\"ph\": \"E\", \"pid\": %d, \"tid\": %zu, \"ts\": %.3f}", rank, thread, ts);
+                            break;
+                        }
+                    }
+                }
+                std::fprintf(out, "\n]}\n");
+                std::fclose(out);
+            }
+        }
+    }
+}